@@ -0,0 +1,618 @@
+// ariel.levovich@msmail.ariel.ac.il
+/**
+ * Micro benchmarks for Ex4.
+ * Usage: ./bench [nodes] [benchmark-name]
+ */
+#include <iostream>
+#include <iomanip>
+#include <stack>
+#include <string>
+#include <vector>
+#include <numeric>
+#include <chrono>
+#include <thread>
+#include "Tree.hpp"
+#include "Complex.hpp"
+#include "ComplexArray.hpp"
+#include "FlatTree.hpp"
+#include "ImplicitTree.hpp"
+#include "ParallelTraversal.hpp"
+
+using namespace std;
+
+template<typename F>
+double time_ms(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - start).count();
+}
+
+void report(const string& name, size_t n, double ms) {
+    cout << left << setw(44) << name << right << setw(10) << fixed << setprecision(2) << ms << " ms"
+         << setw(10) << setprecision(1) << (ms * 1e6 / static_cast<double>(n)) << " ns/node" << endl;
+}
+
+// Build a complete k-ary tree with n nodes, linking nodes allocated from the tree's own storage
+template<size_t K>
+void buildComplete(Tree<int,K>& tree, size_t n) {
+    if (n == 0) return;
+    tree.add_root(Node<int,K>(0));
+    vector<shared_ptr<Node<int,K>>> nodes;
+    nodes.reserve(n);
+    nodes.push_back(tree.getRoot());
+    for (size_t i = 1; i < n; ++i) {
+        nodes.push_back(tree.create_node(Node<int,K>(static_cast<int>(i))));
+        nodes[(i - 1) / K]->add_child(nodes.back());
+    }
+}
+
+void benchNodeStorage(size_t n) {
+    for (auto storage : {NodeStorage::Shared, NodeStorage::Arena}) {
+        string name = (storage == NodeStorage::Shared) ? "shared_ptr" : "arena";
+        Tree<int,2> tree(storage);
+        report("build " + name, n, time_ms([&] { buildComplete(tree, n); }));
+        report("destroy " + name, n, time_ms([&] { tree.clear(); }));
+    }
+}
+
+// Sum every value reached by a begin/end iterator pair
+template<typename Iterator>
+long long sumScan(Iterator node, Iterator end) {
+    long long sum = 0;
+    for (; node != end; ++node) {
+        sum += node.get_value();
+    }
+    return sum;
+}
+
+void benchFlatTree(size_t n) {
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    FlatTree<int,2> flat;
+    report("flatten Tree -> FlatTree", n, time_ms([&] { flat = FlatTree<int,2>(tree); }));
+
+    long long check = 0;
+    report("pre-order Tree", n, time_ms([&] { check += sumScan(tree.begin_pre_order(), tree.end_pre_order()); }));
+    report("pre-order FlatTree", n, time_ms([&] { check -= sumScan(flat.begin_pre_order(), flat.end_pre_order()); }));
+    report("post-order Tree", n, time_ms([&] { check += sumScan(tree.begin_post_order(), tree.end_post_order()); }));
+    report("post-order FlatTree", n, time_ms([&] { check -= sumScan(flat.begin_post_order(), flat.end_post_order()); }));
+    report("bfs Tree", n, time_ms([&] { check += sumScan(tree.begin_bfs_scan(), tree.end_bfs_scan()); }));
+    report("bfs FlatTree", n, time_ms([&] { check -= sumScan(flat.begin_bfs_scan(), flat.end_bfs_scan()); }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchImplicitTree(size_t n) {
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    ImplicitTree<int,2> implicit;
+    report("build ImplicitTree", n, time_ms([&] {
+        implicit.reserve(n);
+        for (size_t i = 0; i < n; ++i) implicit.push_back(static_cast<int>(i));
+    }));
+
+    long long check = 0;
+    report("pre-order Tree", n, time_ms([&] { check += sumScan(tree.begin_pre_order(), tree.end_pre_order()); }));
+    report("pre-order ImplicitTree", n, time_ms([&] { check -= sumScan(implicit.begin_pre_order(), implicit.end_pre_order()); }));
+    report("bfs Tree", n, time_ms([&] { check += sumScan(tree.begin_bfs_scan(), tree.end_bfs_scan()); }));
+    report("bfs ImplicitTree", n, time_ms([&] { check -= sumScan(implicit.begin_bfs_scan(), implicit.end_bfs_scan()); }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchInsertion(size_t n) {
+    // Each tree is destroyed before the next build, so every build reuses memory the previous one freed
+    // Value based inserts search the whole tree every time, so keep that run small
+    size_t small = min<size_t>(n, 20000);
+    {
+        Tree<int,2> by_value;
+        report("add_sub_node by value", small, time_ms([&] {
+            by_value.add_root(Node<int,2>(0));
+            for (size_t i = 1; i < small; ++i) {
+                Node<int,2> parent(static_cast<int>((i - 1) / 2));
+                by_value.add_sub_node(parent, Node<int,2>(static_cast<int>(i)));
+            }
+        }));
+    }
+    {
+        Tree<int,2> indexed;
+        indexed.enable_index();
+        report("add_sub_node by value, indexed", n, time_ms([&] {
+            indexed.add_root(Node<int,2>(0));
+            for (size_t i = 1; i < n; ++i) {
+                Node<int,2> parent(static_cast<int>((i - 1) / 2));
+                indexed.add_sub_node(parent, Node<int,2>(static_cast<int>(i)));
+            }
+        }));
+    }
+
+    vector<int> values(n);
+    vector<size_t> parents(n);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = static_cast<int>(i);
+        parents[i] = (i == 0) ? Tree<int,2>::NO_PARENT : (i - 1) / 2;
+    }
+    // Best of a few rounds after an untimed one, each on a new tree destroyed outside the timing,
+    // so every timed build starts with the allocator holding the nodes of an identical tree
+    auto best_build = [](auto build) {
+        double best = 0;
+        for (int round = 0; round <= 3; ++round) {
+            Tree<int,2> tree;
+            double ms = time_ms([&] { build(tree); });
+            best = (round <= 1) ? ms : min(best, ms);
+        }
+        return best;
+    };
+    report("add_sub_node by handle", n, best_build([&](Tree<int,2>& tree) {
+        vector<NodeHandle<int,2>> handles;
+        handles.reserve(n);
+        handles.push_back(tree.add_root(Node<int,2>(0)));
+        for (size_t i = 1; i < n; ++i) {
+            handles.push_back(tree.add_sub_node(handles[(i - 1) / 2], Node<int,2>(static_cast<int>(i))));
+        }
+    }));
+    report("build_from_parents", n, best_build([&](Tree<int,2>& tree) { tree.build_from_parents(values, parents); }));
+
+    // Parents listed after their children take the general path, which groups children first
+    vector<int> reversed_values(values.rbegin(), values.rend());
+    vector<size_t> reversed_parents(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t parent = parents[n - 1 - i];
+        reversed_parents[i] = (parent == Tree<int,2>::NO_PARENT) ? parent : n - 1 - parent;
+    }
+    report("build_from_parents, children first", n, best_build([&](Tree<int,2>& tree) {
+        tree.build_from_parents(reversed_values, reversed_parents);
+    }));
+}
+
+void benchValueAccess(size_t n) {
+    // A heavyweight value type: every copy allocates and copies 256 bytes
+    Tree<string,2> tree;
+    vector<NodeHandle<string,2>> handles;
+    handles.reserve(n);
+    handles.push_back(tree.emplace_root(256, 'a'));
+    for (size_t i = 1; i < n; ++i) {
+        handles.push_back(tree.emplace_child(handles[(i - 1) / 2], 256, static_cast<char>('a' + i % 26)));
+    }
+
+    size_t by_copy = 0, by_reference = 0;
+    report("pre-order string, copy each value", n, time_ms([&] {
+        for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node) {
+            string value = node.get_value();
+            by_copy += value[0];
+        }
+    }));
+    report("pre-order string, const reference", n, time_ms([&] {
+        for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node) {
+            const string& value = *node;
+            by_reference += value[0];
+        }
+    }));
+    if (by_copy != by_reference) cout << "checksum mismatch" << endl;
+}
+
+void benchTeardown(size_t n) {
+    for (auto storage : {NodeStorage::Shared, NodeStorage::Arena}) {
+        string name = (storage == NodeStorage::Shared) ? "shared_ptr" : "arena";
+
+        Tree<int,2> chain(storage);
+        auto node = chain.add_root(Node<int,2>(0));
+        for (size_t i = 1; i < n; ++i) {
+            node = chain.add_sub_node(node, Node<int,2>(static_cast<int>(i)));
+        }
+        report("destroy chain " + name, n, time_ms([&] { chain.clear(); }));
+
+        Tree<int,8> bushy(storage);
+        vector<NodeHandle<int,8>> handles;
+        handles.reserve(n);
+        handles.push_back(bushy.add_root(Node<int,8>(0)));
+        for (size_t i = 1; i < n; ++i) {
+            handles.push_back(bushy.add_sub_node(handles[(i - 1) / 8], Node<int,8>(static_cast<int>(i))));
+        }
+        report("destroy bushy 8-ary " + name, n, time_ms([&] { bushy.clear(); }));
+    }
+}
+
+// Pre-order as the iterators used to step: a stack of shared_ptrs, and a std::vector copy of
+// every child list, as when nodes kept their children in a vector. Kept as the baseline.
+template<size_t K>
+long long sumPreOrderCopying(const shared_ptr<Node<int,K>>& root) {
+    long long sum = 0;
+    stack<shared_ptr<Node<int,K>>> pending;
+    pending.push(root);
+    while (!pending.empty()) {
+        auto node = pending.top();
+        pending.pop();
+        sum += node->get_value();
+        vector<shared_ptr<Node<int,K>>> children(node->get_children().begin(), node->get_children().end());
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            pending.push(*it);
+        }
+    }
+    return sum;
+}
+
+template<size_t K>
+void benchScanWidth(size_t n) {
+    Tree<int,K> tree;
+    vector<NodeHandle<int,K>> handles;
+    handles.reserve(n);
+    handles.push_back(tree.add_root(Node<int,K>(0)));
+    for (size_t i = 1; i < n; ++i) {
+        handles.push_back(tree.add_sub_node(handles[(i - 1) / K], Node<int,K>(static_cast<int>(i))));
+    }
+    long long check = 0;
+    long long baseline = 0;
+    string k = "K=" + to_string(K);
+    report("pre-order copying baseline " + k, n, time_ms([&] { baseline = sumPreOrderCopying(tree.getRoot()); }));
+    report("pre-order " + k, n, time_ms([&] { check += sumScan(tree.begin_pre_order(), tree.end_pre_order()); }));
+    report("in-order " + k, n, time_ms([&] { check -= sumScan(tree.begin_in_order(), tree.end_in_order()); }));
+    report("dfs " + k, n, time_ms([&] { check += sumScan(tree.begin_dfs_scan(), tree.end_dfs_scan()); }));
+    report("post-order " + k, n, time_ms([&] { check -= sumScan(tree.begin_post_order(), tree.end_post_order()); }));
+    if (check != 0 || baseline != static_cast<long long>(n * (n - 1) / 2)) cout << "checksum mismatch" << endl;
+}
+
+void benchScans(size_t n) {
+    benchScanWidth<2>(n);
+    benchScanWidth<4>(n);
+    benchScanWidth<8>(n);
+    benchScanWidth<16>(n);
+    benchScanWidth<64>(n);
+}
+
+void benchSmallTraversals(size_t n) {
+    // Many short traversals: one per 15-node subtree of a complete binary tree
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    size_t height = 0;
+    for (auto node = tree.getRoot(); !node->get_children().empty(); node = node->get_children()[0]) {
+        ++height;
+    }
+    // Collect every node 3 levels above the deepest one by walking the level order
+    vector<shared_ptr<Node<int,2>>> level{tree.getRoot()};
+    for (size_t depth = 0; depth + 3 < height; ++depth) {
+        vector<shared_ptr<Node<int,2>>> next;
+        for (auto& node : level) {
+            for (auto& child : node->get_children()) next.push_back(child);
+        }
+        level.swap(next);
+    }
+
+    long long check = 0;
+    report("pre-order of small subtrees", n, time_ms([&] {
+        for (auto& root : level) {
+            for (PreOrderIterator<int,2> it(root); it != PreOrderIterator<int,2>(nullptr); ++it) check += *it;
+        }
+    }));
+    report("bfs of small subtrees", n, time_ms([&] {
+        for (auto& root : level) {
+            for (BFSIterator<int,2> it(root); it != BFSIterator<int,2>(nullptr); ++it) check -= *it;
+        }
+    }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchLevels(size_t n) {
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    long long check = 0;
+    report("bfs node by node", n, time_ms([&] { check += sumScan(tree.begin_bfs_scan(), tree.end_bfs_scan()); }));
+    report("bfs level by level", n, time_ms([&] {
+        for (auto level = tree.begin_levels(); level != tree.end_levels(); ++level) {
+            for (auto node = level.begin_level(); node != level.end_level(); ++node) {
+                check -= (*node)->get_value();
+            }
+        }
+    }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchForEach(size_t n) {
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    long long check = 0;
+    auto add = [&](int value) { check += value; };
+    auto subtract = [&](int value) { check -= value; };
+    report("pre-order iterator", n, time_ms([&] { check += sumScan(tree.begin_pre_order(), tree.end_pre_order()); }));
+    report("pre-order for_each", n, time_ms([&] { tree.for_each_pre_order(subtract); }));
+    report("post-order iterator", n, time_ms([&] { check += sumScan(tree.begin_post_order(), tree.end_post_order()); }));
+    report("post-order for_each", n, time_ms([&] { tree.for_each_post_order(subtract); }));
+    report("bfs iterator", n, time_ms([&] { check -= sumScan(tree.begin_bfs_scan(), tree.end_bfs_scan()); }));
+    report("bfs for_each", n, time_ms([&] { tree.for_each_bfs(add); }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchPruning(size_t n) {
+    // Search the top 11 levels of a complete binary tree, about 2K of the nodes
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    const int cutoff = 1023;
+    long long check = 0;
+    report("pre-order filter afterwards", n, time_ms([&] {
+        for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node) {
+            if (*node < 2 * cutoff + 1) check += *node;
+        }
+    }));
+    report("pre-order skip_children", n, time_ms([&] {
+        for (auto node = tree.begin_pre_order(); node != tree.end_pre_order();) {
+            check -= *node;
+            if (*node >= cutoff) node.skip_children(); else ++node;
+        }
+    }));
+    report("for_each_pre_order SkipChildren", n, time_ms([&] {
+        tree.for_each_pre_order([&](int value) {
+            check += value;
+            return (value >= cutoff) ? VisitResult::SkipChildren : VisitResult::Continue;
+        });
+    }));
+    report("bfs skip_children", n, time_ms([&] {
+        for (auto node = tree.begin_bfs_scan(); node != tree.end_bfs_scan();) {
+            check -= *node;
+            if (*node >= cutoff) node.skip_children(); else ++node;
+        }
+    }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchStackless(size_t n) {
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    cout << "iterator size: stack " << sizeof(PreOrderIterator<int,2>) << " bytes, stackless "
+         << sizeof(StacklessPreOrderIterator<int,2>) << " bytes" << endl;
+    long long check = 0;
+    report("pre-order stack", n, time_ms([&] { check += sumScan(tree.begin_pre_order(), tree.end_pre_order()); }));
+    report("pre-order stackless", n, time_ms([&] { check -= sumScan(tree.begin_stackless_pre_order(), tree.end_stackless_pre_order()); }));
+    report("post-order stack", n, time_ms([&] { check += sumScan(tree.begin_post_order(), tree.end_post_order()); }));
+    report("post-order stackless", n, time_ms([&] { check -= sumScan(tree.begin_stackless_post_order(), tree.end_stackless_post_order()); }));
+    report("in-order stack", n, time_ms([&] { check += sumScan(tree.begin_in_order(), tree.end_in_order()); }));
+    report("in-order stackless", n, time_ms([&] { check -= sumScan(tree.begin_stackless_in_order(), tree.end_stackless_in_order()); }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+// The 10 smallest values: copying heap and bounded top_k
+template<typename T>
+void benchSmallest(Tree<T,2>& tree, size_t n, const string& type) {
+    const size_t k = 10;
+    vector<T> by_copy, bounded;
+    report("first 10, HeapIterator " + type, n, time_ms([&] {
+        auto it = tree.myHeap();
+        for (size_t i = 0; i < k && it != default_sentinel; ++i, ++it) by_copy.push_back(*it);
+    }));
+    report("top_k(10) " + type, n, time_ms([&] { bounded = tree.top_k(k); }));
+    if (by_copy != bounded) cout << "checksum mismatch" << endl;
+}
+
+void benchHeap(size_t n) {
+    Tree<int,2> ints;
+    vector<NodeHandle<int,2>> handles;
+    handles.reserve(n);
+    // Scrambled values, so the heap does real work
+    handles.push_back(ints.add_root(Node<int,2>(0)));
+    for (size_t i = 1; i < n; ++i) {
+        handles.push_back(ints.add_sub_node(handles[(i - 1) / 2], Node<int,2>(static_cast<int>((i * 2654435761u) % n))));
+    }
+    benchSmallest(ints, n, "int");
+
+    size_t small = min<size_t>(n, 200000);
+    Tree<string,2> strings;
+    vector<NodeHandle<string,2>> string_handles;
+    string_handles.reserve(small);
+    string_handles.push_back(strings.emplace_root(64, 'a'));
+    for (size_t i = 1; i < small; ++i) {
+        string value = to_string((i * 2654435761u) % small);
+        value.resize(64, '.');
+        string_handles.push_back(strings.emplace_child(string_handles[(i - 1) / 2], std::move(value)));
+    }
+    benchSmallest(strings, small, "string");
+}
+
+void benchHeapOrdered(size_t n) {
+    // Values in BFS order, so every parent is smaller than its children
+    Tree<int,2> tree;
+    buildComplete(tree, n);
+    long long check = 0;
+    auto firstTen = [&](HeapIterator<int,2> it, long long sign) {
+        for (size_t i = 0; i < 10 && it.isNotEmpty(); ++i, ++it) check += sign * *it;
+    };
+    // The copying path is built directly; myHeap() picks the frontier for this tree
+    report("first 10, copy and sort", n, time_ms([&] { firstTen(HeapIterator<int,2>(tree.getRoot()), 1); }));
+    report("full sorted scan, copy and sort", n, time_ms([&] { check += sumScan(HeapIterator<int,2>(tree.getRoot()), tree.emptyHeap()); }));
+    bool ordered = false;
+    report("is_heap_ordered", n, time_ms([&] { ordered = tree.is_heap_ordered(); }));
+    if (!ordered) cout << "tree should be heap-ordered" << endl;
+    report("first 10, myHeap (check + frontier)", n, time_ms([&] { firstTen(tree.myHeap(), -1); }));
+    report("full sorted scan, myHeap (check + frontier)", n, time_ms([&] { check -= sumScan(tree.myHeap(), tree.emptyHeap()); }));
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+void benchParallelHeap(size_t n) {
+    Tree<int,2> tree;
+    vector<NodeHandle<int,2>> handles;
+    handles.reserve(n);
+    handles.push_back(tree.add_root(Node<int,2>(0)));
+    for (size_t i = 1; i < n; ++i) {
+        handles.push_back(tree.add_sub_node(handles[(i - 1) / 2], Node<int,2>(static_cast<int>((i * 2654435761u) % n))));
+    }
+    long long expected = 0, sum = 0;
+    report("full sorted scan, myHeap", n, time_ms([&] { expected = sumScan(tree.myHeap(), tree.emptyHeap()); }));
+    // Up to the hardware threads, and at least 4 to show the split overhead on small machines
+    size_t most = max<size_t>(4, thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= most; threads *= 2) {
+        report("full sorted scan, " + to_string(threads) + " threads", n, time_ms([&] {
+            sum = 0;
+            for (int value : tree.parallel_heap(threads)) sum += value;
+        }));
+        if (sum != expected) cout << "checksum mismatch" << endl;
+    }
+}
+
+// Full ascending scan through the radix path and through the heap, which std::greater<> selects
+template<typename T>
+void benchRadixType(size_t n, const string& type, T scale) {
+    Tree<T,2> tree;
+    vector<NodeHandle<T,2>> handles;
+    handles.reserve(n);
+    handles.push_back(tree.add_root(Node<T,2>(T(0))));
+    for (size_t i = 1; i < n; ++i) {
+        T value = static_cast<T>(static_cast<long long>((i * 2654435761u) % n) - static_cast<long long>(n / 2)) / scale;
+        handles.push_back(tree.add_sub_node(handles[(i - 1) / 2], Node<T,2>(value)));
+    }
+    double radix_sum = 0, heap_sum = 0;
+    report("sorted scan " + type + ", radix", n, time_ms([&] {
+        for (auto it = tree.myHeap(); it.isNotEmpty(); ++it) radix_sum += *it;
+    }));
+    report("sorted scan " + type + ", heap", n, time_ms([&] {
+        for (HeapIterator<T,2,greater<>> it(tree.getRoot()); it.isNotEmpty(); ++it) heap_sum += *it;
+    }));
+    if (radix_sum != heap_sum) cout << "checksum mismatch" << endl;
+}
+
+void benchRadix(size_t n) {
+    benchRadixType<int>(n, "int", 1);
+    benchRadixType<double>(n, "double", 8.0);
+}
+
+void benchComplexKeys(size_t n) {
+    Tree<Complex,2> tree;
+    vector<NodeHandle<Complex,2>> handles;
+    handles.reserve(n);
+    handles.push_back(tree.add_root(Node<Complex,2>(Complex(0, 0))));
+    for (size_t i = 1; i < n; ++i) {
+        double real = static_cast<double>((i * 2654435761u) % 20011) - 10005.0;
+        double imag = static_cast<double>((i * 40503u) % 19997) - 9998.0;
+        handles.push_back(tree.add_sub_node(handles[(i - 1) / 2], Node<Complex,2>(Complex(real, imag))));
+    }
+    double keyed = 0, compared = 0;
+    report("sorted scan Complex, cached keys", n, time_ms([&] {
+        for (auto it = tree.myHeap(); it.isNotEmpty(); ++it) keyed += it->getReal();
+    }));
+    report("sorted scan Complex, operator> heap", n, time_ms([&] {
+        for (HeapIterator<Complex,2,greater<>> it(tree.getRoot()); it.isNotEmpty(); ++it) compared += it->getReal();
+    }));
+    if (keyed != compared) cout << "checksum mismatch" << endl;
+}
+
+void benchComplexArray(size_t n) {
+    vector<Complex> a, b;
+    a.reserve(n);
+    b.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        a.emplace_back(static_cast<double>(i % 1000) - 500.0, static_cast<double>(i % 777) - 388.0);
+        b.emplace_back(static_cast<double>(i % 313) - 156.0, static_cast<double>(i % 911) - 455.0);
+    }
+    // Outputs are allocated up front on both sides, so only the kernels are timed
+    ComplexArray left(a), right(b);
+    cout << "SIMD lanes: " << SIMD_LANES << endl;
+
+    double check = 0;
+    vector<double> magnitudes(n);
+    vector<Complex> products(n);
+    vector<uint8_t> greater(n);
+    report("magnitude, vector<Complex>", n, time_ms([&] {
+        for (size_t i = 0; i < n; ++i) magnitudes[i] = a[i].sort_key();
+    }));
+    check += magnitudes[n / 2];
+    report("magnitude, ComplexArray", n, time_ms([&] { left.magnitudes(magnitudes); }));
+    check -= magnitudes[n / 2];
+    report("multiply, vector<Complex>", n, time_ms([&] {
+        for (size_t i = 0; i < n; ++i) products[i] = a[i] * b[i];
+    }));
+    check += products[n / 2].getReal();
+    ComplexArray product(n);
+    report("multiply, ComplexArray", n, time_ms([&] { left.multiply(right, product); }));
+    check -= product[n / 2].getReal();
+    report("compare, vector<Complex>", n, time_ms([&] {
+        for (size_t i = 0; i < n; ++i) greater[i] = a[i] > b[i];
+    }));
+    check += greater[n / 2];
+    report("compare, ComplexArray", n, time_ms([&] { left.greater_than(right, greater); }));
+    check -= greater[n / 2];
+    if (check != 0) cout << "checksum mismatch" << endl;
+}
+
+// Skewed tree of n nodes under parent: the first child takes 90% of the rest, the second child 10%
+template<size_t K>
+void buildSkewed(Tree<int,K>& tree, const shared_ptr<Node<int,K>>& parent, size_t n, int& next) {
+    if (n == 0) return;
+    auto node = tree.create_node(Node<int,K>(next++));
+    parent->add_child(node);
+    size_t heavy = (n - 1) * 9 / 10;
+    buildSkewed(tree, node, heavy, next);
+    buildSkewed(tree, node, n - 1 - heavy, next);
+}
+
+// A few hundred cycles of integer mixing, so the per-node work dominates the walk
+long long mix(int value) {
+    unsigned long long x = static_cast<unsigned long long>(value);
+    for (int round = 0; round < 64; ++round) x = (x ^ (x >> 29)) * 0xBF58476D1CE4E5B9ULL + round;
+    return static_cast<long long>(x & 0xFFFF);
+}
+
+void benchParallelShape(Tree<int,2>& tree, size_t n, const string& shape) {
+    long long expected = 0, mixed = 0;
+    tree.for_each_pre_order([&](int value) { expected += value; mixed += mix(value); });
+    size_t most = max<size_t>(4, thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= most; threads *= 2) {
+        WorkStealingPool pool(threads);
+        long long sum = 0;
+        report(shape + " reduce, " + to_string(threads) + " threads", n, time_ms([&] {
+            sum = parallel_reduce(tree, 0LL, plus<>(), pool);
+        }));
+        if (sum != expected) cout << "checksum mismatch" << endl;
+        // Values are 0..n-1, so each one owns a slot and the threads share no counter
+        vector<long long> out(n);
+        report(shape + " mixing for_each, " + to_string(threads) + " threads", n, time_ms([&] {
+            parallel_for_each(tree, [&out](int value) { out[value] = mix(value); }, pool);
+        }));
+        if (accumulate(out.begin(), out.end(), 0LL) != mixed) cout << "checksum mismatch" << endl;
+    }
+}
+
+// Scaling of the work-stealing traversals from 1 thread up, on a balanced and a skewed tree
+void benchParallel(size_t n) {
+    Tree<int,2> balanced;
+    buildComplete(balanced, n);
+    benchParallelShape(balanced, n, "balanced");
+
+    Tree<int,2> skewed;
+    if (n > 0) {
+        skewed.add_root(Node<int,2>(0));
+        int next = 1;
+        size_t heavy = (n - 1) * 9 / 10;
+        buildSkewed(skewed, skewed.getRoot(), heavy, next);
+        buildSkewed(skewed, skewed.getRoot(), n - 1 - heavy, next);
+    }
+    benchParallelShape(skewed, n, "skewed");
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? stoul(argv[1]) : 1000000;
+    string only = (argc > 2) ? argv[2] : "";
+
+    auto run = [&](const string& name, void (*bench)(size_t)) {
+        if (only.empty() || only == name) {
+            cout << "== " << name << " (" << n << " nodes)" << endl;
+            bench(n);
+        }
+    };
+
+    run("storage", benchNodeStorage);
+    run("flat", benchFlatTree);
+    run("implicit", benchImplicitTree);
+    run("insert", benchInsertion);
+    run("value", benchValueAccess);
+    run("teardown", benchTeardown);
+    run("scan", benchScans);
+    run("small", benchSmallTraversals);
+    run("levels", benchLevels);
+    run("foreach", benchForEach);
+    run("prune", benchPruning);
+    run("stackless", benchStackless);
+    run("heap", benchHeap);
+    run("heap-ordered", benchHeapOrdered);
+    run("parallel-heap", benchParallelHeap);
+    run("radix", benchRadix);
+    run("complex-keys", benchComplexKeys);
+    run("complex-array", benchComplexArray);
+    run("parallel", benchParallel);
+    return 0;
+}
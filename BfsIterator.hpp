@@ -3,32 +3,78 @@
 #define BFS_ITERATOR_HPP
 
 #include "Node.hpp"
-// BFS iterator
+#include "TraversalBuffer.hpp"
+#include <cstddef>
+#include <iterator>
+// BFS iterator, queueing raw node pointers in a small inline ring buffer
 template<typename T, size_t K>
 class BFSIterator {
     private:
-        std::queue<std::shared_ptr<Node<T,K>>> queue;
+        SmallQueue<Node<T,K>*> queue;
+
+        Node<T,K>* position() const {
+            return queue.empty() ? nullptr : queue.front();
+        }
 
     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        BFSIterator() = default;
+
         explicit BFSIterator(std::shared_ptr<Node<T,K>> root) {
-            if (root) queue.push(root);
+            if (root) queue.push(root.get());
+        }
+
+        // Grow the queue inside a caller-owned scratch buffer, so repeated traversals allocate nothing
+        BFSIterator(std::shared_ptr<Node<T,K>> root, std::vector<Node<T,K>*>& scratch) : queue(scratch) {
+            if (root) queue.push(root.get());
+        }
+
+        bool operator==(const BFSIterator& other) const {
+            return position() == other.position();
         }
 
-        bool operator!=(const BFSIterator& other) const {
-            return !queue.empty() || !other.queue.empty();
+        bool operator==(std::default_sentinel_t) const {
+            return queue.empty();
         }
 
-        T get_value() const {
+        const T& get_value() const {
             return queue.front()->get_value();
         }
 
+        const T& operator*() const {
+            return queue.front()->get_value();
+        }
+
+        const T* operator->() const {
+            return &queue.front()->get_value();
+        }
+
         BFSIterator& operator++() {
-            auto node = queue.front();
+            Node<T,K>* node = queue.front();
             queue.pop();
-            for (auto& child : node->get_children()) {
-                queue.push(child);
+            for (const auto& child : node->get_children()) {
+                queue.push(child.get());
+            }
+            return *this;
+        }
+
+        BFSIterator operator++(int) {
+            BFSIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        // Move past the current node without visiting its subtree
+        BFSIterator& skip_children() {
+            if (!queue.empty()) {
+                queue.pop();
             }
             return *this;
         }
 };    
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,80 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef CHILD_ARRAY_HPP
+#define CHILD_ARRAY_HPP
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+// Fixed-capacity child list stored inline in the node.
+// Offers the subset of the std::vector interface the tree and its iterators use.
+template<typename P, size_t N>
+class ChildArray {
+private:
+    std::array<P, N> items{};
+    size_t count = 0;
+
+public:
+    using value_type = P;
+    using size_type = size_t;
+    using reference = P&;
+    using const_reference = const P&;
+    using iterator = P*;
+    using const_iterator = const P*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    ChildArray() = default;
+    ChildArray(const ChildArray&) = default;
+    ChildArray& operator=(const ChildArray&) = default;
+
+    // Moving leaves the source empty, like a moved-from std::vector
+    ChildArray(ChildArray&& other) noexcept : items(std::move(other.items)), count(other.count) {
+        other.count = 0;
+    }
+
+    ChildArray& operator=(ChildArray&& other) noexcept {
+        if (this != &other) {
+            items = std::move(other.items);
+            count = other.count;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    iterator begin() { return items.data(); }
+    iterator end() { return items.data() + count; }
+    const_iterator begin() const { return items.data(); }
+    const_iterator end() const { return items.data() + count; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    P& operator[](size_t i) { return items[i]; }
+    const P& operator[](size_t i) const { return items[i]; }
+    P& front() { return items[0]; }
+    const P& front() const { return items[0]; }
+    P& back() { return items[count - 1]; }
+    const P& back() const { return items[count - 1]; }
+
+    // Caller must check size() < capacity() first, like Node::add_child does
+    void push_back(const P& item) {
+        items[count++] = item;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = P();
+        }
+        count = 0;
+    }
+};
+
+#endif
@@ -4,35 +4,54 @@
 #include <iostream>
 #include <sstream>
 #include <cmath> 
+#include <functional>
 
+// Complex number ordered by magnitude.
+// Copies are the implicit memberwise ones, so it is trivially copyable and bulk moves are memcpy.
 class Complex {
 private:
     double real;    
     double imag;    
 
 public:
-    Complex() : real(0), imag(0) {}
+    constexpr Complex() : real(0), imag(0) {}
 
-    Complex(double r, double i) : real(r), imag(i) {}
+    constexpr Complex(double r, double i) : real(r), imag(i) {}
 
-    Complex(const Complex& c) {
-        real = c.real;
-        imag = c.imag;
-    }
-
-    double getReal() const { return real; }
-    double getImag() const { return imag; }    
+    constexpr double getReal() const { return real; }
+    constexpr double getImag() const { return imag; }    
 
-    bool operator==(const Complex& other) const {
+    constexpr bool operator==(const Complex& other) const {
         return real == other.real && imag == other.imag;
     }
 
-    bool operator!=(const Complex& other) const {
+    constexpr bool operator!=(const Complex& other) const {
         return !(*this == other);
     }
     
     bool operator>(const Complex& other) const {
-        return (std::sqrt(real * real + imag * imag) > std::sqrt(other.real * other.real + other.imag * other.imag));
+        return sort_key() > other.sort_key();
+    }
+
+    // Magnitude, the key operator> compares; sorted scans compute it once per value
+    double sort_key() const {
+        return std::sqrt(squared_magnitude());
+    }
+
+    constexpr double squared_magnitude() const {
+        return real * real + imag * imag;
+    }
+
+    constexpr Complex operator+(const Complex& other) const {
+        return Complex(real + other.real, imag + other.imag);
+    }
+
+    constexpr Complex operator*(const Complex& other) const {
+        return Complex(real * other.real - imag * other.imag, real * other.imag + imag * other.real);
+    }
+
+    constexpr Complex conjugate() const {
+        return Complex(real, -imag);
     }
 
     std::string toString() const {
@@ -48,4 +67,15 @@ public:
     // Friend function to overload operator<<
     friend std::ostream& operator<<(std::ostream& os, const Complex& c);
 };
+
+// Hash for Complex so it can key unordered containers such as the Tree value index
+namespace std {
+    template<>
+    struct hash<Complex> {
+        size_t operator()(const Complex& c) const {
+            size_t h = hash<double>{}(c.getReal());
+            return h ^ (hash<double>{}(c.getImag()) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+        }
+    };
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,255 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef COMPLEX_ARRAY_HPP
+#define COMPLEX_ARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "Complex.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Vector of doubles the kernels process per step: AVX (4 lanes), SSE2 (2 lanes) or plain scalar.
+// Every kernel is written once against these wrappers; a scalar loop finishes the tail.
+#if defined(__AVX__)
+using SimdDouble = __m256d;
+constexpr size_t SIMD_LANES = 4;
+inline SimdDouble simd_load(const double* p) { return _mm256_loadu_pd(p); }
+inline void simd_store(double* p, SimdDouble v) { _mm256_storeu_pd(p, v); }
+inline SimdDouble simd_add(SimdDouble a, SimdDouble b) { return _mm256_add_pd(a, b); }
+inline SimdDouble simd_sub(SimdDouble a, SimdDouble b) { return _mm256_sub_pd(a, b); }
+inline SimdDouble simd_mul(SimdDouble a, SimdDouble b) { return _mm256_mul_pd(a, b); }
+inline SimdDouble simd_sqrt(SimdDouble a) { return _mm256_sqrt_pd(a); }
+inline SimdDouble simd_neg(SimdDouble a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+inline int simd_greater_bits(SimdDouble a, SimdDouble b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+inline int simd_equal_bits(SimdDouble a, SimdDouble b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+#elif defined(__SSE2__)
+using SimdDouble = __m128d;
+constexpr size_t SIMD_LANES = 2;
+inline SimdDouble simd_load(const double* p) { return _mm_loadu_pd(p); }
+inline void simd_store(double* p, SimdDouble v) { _mm_storeu_pd(p, v); }
+inline SimdDouble simd_add(SimdDouble a, SimdDouble b) { return _mm_add_pd(a, b); }
+inline SimdDouble simd_sub(SimdDouble a, SimdDouble b) { return _mm_sub_pd(a, b); }
+inline SimdDouble simd_mul(SimdDouble a, SimdDouble b) { return _mm_mul_pd(a, b); }
+inline SimdDouble simd_sqrt(SimdDouble a) { return _mm_sqrt_pd(a); }
+inline SimdDouble simd_neg(SimdDouble a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+inline int simd_greater_bits(SimdDouble a, SimdDouble b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+inline int simd_equal_bits(SimdDouble a, SimdDouble b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+#else
+using SimdDouble = double;
+constexpr size_t SIMD_LANES = 1;
+inline SimdDouble simd_load(const double* p) { return *p; }
+inline void simd_store(double* p, SimdDouble v) { *p = v; }
+inline SimdDouble simd_add(SimdDouble a, SimdDouble b) { return a + b; }
+inline SimdDouble simd_sub(SimdDouble a, SimdDouble b) { return a - b; }
+inline SimdDouble simd_mul(SimdDouble a, SimdDouble b) { return a * b; }
+inline SimdDouble simd_sqrt(SimdDouble a) { return std::sqrt(a); }
+inline SimdDouble simd_neg(SimdDouble a) { return -a; }
+inline int simd_greater_bits(SimdDouble a, SimdDouble b) { return a > b; }
+inline int simd_equal_bits(SimdDouble a, SimdDouble b) { return a == b; }
+#endif
+
+// Structure-of-arrays complex vector: all real parts in one array, all imaginary parts in another,
+// so the element-wise kernels below run SIMD_LANES values per instruction.
+// Results match the scalar Complex operations exactly.
+class ComplexArray {
+private:
+    std::vector<double> real;
+    std::vector<double> imag;
+
+    void check_size(const ComplexArray& other) const {
+        if (other.size() != size()) {
+            throw std::invalid_argument("ComplexArray: arrays differ in size");
+        }
+    }
+
+public:
+    ComplexArray() = default;
+
+    explicit ComplexArray(size_t n) : real(n), imag(n) {}
+
+    explicit ComplexArray(const std::vector<Complex>& values) {
+        reserve(values.size());
+        for (const Complex& value : values) push_back(value);
+    }
+
+    size_t size() const {
+        return real.size();
+    }
+
+    bool empty() const {
+        return real.empty();
+    }
+
+    void reserve(size_t n) {
+        real.reserve(n);
+        imag.reserve(n);
+    }
+
+    void resize(size_t n) {
+        real.resize(n);
+        imag.resize(n);
+    }
+
+    void push_back(const Complex& value) {
+        real.push_back(value.getReal());
+        imag.push_back(value.getImag());
+    }
+
+    Complex operator[](size_t i) const {
+        return Complex(real[i], imag[i]);
+    }
+
+    void set(size_t i, const Complex& value) {
+        real[i] = value.getReal();
+        imag[i] = value.getImag();
+    }
+
+    const double* real_data() const {
+        return real.data();
+    }
+
+    const double* imag_data() const {
+        return imag.data();
+    }
+
+    // Each kernel writes into out, resizing it; passing the same out again reuses its memory.
+    // The value-returning forms allocate a fresh result.
+
+    // |z|^2 per element
+    void squared_magnitudes(std::vector<double>& out) const {
+        out.resize(size());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            SimdDouble re = simd_load(&real[i]), im = simd_load(&imag[i]);
+            simd_store(&out[i], simd_add(simd_mul(re, re), simd_mul(im, im)));
+        }
+        for (; i < size(); ++i) out[i] = (*this)[i].squared_magnitude();
+    }
+
+    // |z| per element, the key Complex::operator> compares
+    void magnitudes(std::vector<double>& out) const {
+        out.resize(size());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            SimdDouble re = simd_load(&real[i]), im = simd_load(&imag[i]);
+            simd_store(&out[i], simd_sqrt(simd_add(simd_mul(re, re), simd_mul(im, im))));
+        }
+        for (; i < size(); ++i) out[i] = (*this)[i].sort_key();
+    }
+
+    // Element-wise sum; throws std::invalid_argument if the sizes differ
+    void add(const ComplexArray& other, ComplexArray& out) const {
+        check_size(other);
+        out.resize(size());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            simd_store(&out.real[i], simd_add(simd_load(&real[i]), simd_load(&other.real[i])));
+            simd_store(&out.imag[i], simd_add(simd_load(&imag[i]), simd_load(&other.imag[i])));
+        }
+        for (; i < size(); ++i) out.set(i, (*this)[i] + other[i]);
+    }
+
+    // Element-wise product; throws std::invalid_argument if the sizes differ
+    void multiply(const ComplexArray& other, ComplexArray& out) const {
+        check_size(other);
+        out.resize(size());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            SimdDouble a = simd_load(&real[i]), b = simd_load(&imag[i]);
+            SimdDouble c = simd_load(&other.real[i]), d = simd_load(&other.imag[i]);
+            simd_store(&out.real[i], simd_sub(simd_mul(a, c), simd_mul(b, d)));
+            simd_store(&out.imag[i], simd_add(simd_mul(a, d), simd_mul(b, c)));
+        }
+        for (; i < size(); ++i) out.set(i, (*this)[i] * other[i]);
+    }
+
+    void conjugate(ComplexArray& out) const {
+        out.resize(size());
+        std::copy(real.begin(), real.end(), out.real.begin());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            simd_store(&out.imag[i], simd_neg(simd_load(&imag[i])));
+        }
+        for (; i < size(); ++i) out.imag[i] = -imag[i];
+    }
+
+    // 1 where (*this)[i] > other[i] by magnitude, as Complex::operator>, else 0
+    void greater_than(const ComplexArray& other, std::vector<uint8_t>& out) const {
+        check_size(other);
+        out.resize(size());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            SimdDouble re = simd_load(&real[i]), im = simd_load(&imag[i]);
+            SimdDouble other_re = simd_load(&other.real[i]), other_im = simd_load(&other.imag[i]);
+            int bits = simd_greater_bits(simd_sqrt(simd_add(simd_mul(re, re), simd_mul(im, im))),
+                                         simd_sqrt(simd_add(simd_mul(other_re, other_re), simd_mul(other_im, other_im))));
+            for (size_t lane = 0; lane < SIMD_LANES; ++lane) out[i + lane] = (bits >> lane) & 1;
+        }
+        for (; i < size(); ++i) out[i] = (*this)[i] > other[i];
+    }
+
+    // 1 where (*this)[i] == other[i], else 0
+    void equal_to(const ComplexArray& other, std::vector<uint8_t>& out) const {
+        check_size(other);
+        out.resize(size());
+        size_t i = 0;
+        for (; i + SIMD_LANES <= size(); i += SIMD_LANES) {
+            int bits = simd_equal_bits(simd_load(&real[i]), simd_load(&other.real[i]))
+                     & simd_equal_bits(simd_load(&imag[i]), simd_load(&other.imag[i]));
+            for (size_t lane = 0; lane < SIMD_LANES; ++lane) out[i + lane] = (bits >> lane) & 1;
+        }
+        for (; i < size(); ++i) out[i] = (*this)[i] == other[i];
+    }
+
+    std::vector<double> squared_magnitudes() const {
+        std::vector<double> out;
+        squared_magnitudes(out);
+        return out;
+    }
+
+    std::vector<double> magnitudes() const {
+        std::vector<double> out;
+        magnitudes(out);
+        return out;
+    }
+
+    ComplexArray operator+(const ComplexArray& other) const {
+        ComplexArray out;
+        add(other, out);
+        return out;
+    }
+
+    ComplexArray operator*(const ComplexArray& other) const {
+        ComplexArray out;
+        multiply(other, out);
+        return out;
+    }
+
+    ComplexArray conjugate() const {
+        ComplexArray out;
+        conjugate(out);
+        return out;
+    }
+
+    std::vector<uint8_t> greater_than(const ComplexArray& other) const {
+        std::vector<uint8_t> out;
+        greater_than(other, out);
+        return out;
+    }
+
+    std::vector<uint8_t> equal_to(const ComplexArray& other) const {
+        std::vector<uint8_t> out;
+        equal_to(other, out);
+        return out;
+    }
+};
+
+#endif
@@ -3,30 +3,76 @@
 #define DFS_ITERATOR_HPP
 
 #include "Node.hpp"
-// DFS iterator
+#include "TraversalBuffer.hpp"
+#include <cstddef>
+#include <iterator>
+// DFS iterator, keeping raw node pointers like PreOrderIterator
 template<typename T, size_t K>
 class DFSIterator {
 private:
-    std::stack<std::shared_ptr<Node<T,K>>> stack;
+    SmallStack<Node<T,K>*> stack;
+
+    Node<T,K>* position() const {
+        return stack.empty() ? nullptr : stack.top();
+    }
 
 public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    DFSIterator() = default;
+
     explicit DFSIterator(std::shared_ptr<Node<T,K>> root) {
-        if (root) stack.push(root);
+        if (root) stack.push(root.get());
+    }
+
+    DFSIterator(std::shared_ptr<Node<T,K>> root, std::vector<Node<T,K>*>& scratch) : stack(scratch) {
+        if (root) stack.push(root.get());
+    }
+
+    bool operator==(const DFSIterator& other) const {
+        return position() == other.position();
     }
 
-    bool operator!=(const DFSIterator& other) const {
-        return !stack.empty() || !other.stack.empty();
+    bool operator==(std::default_sentinel_t) const {
+        return stack.empty();
     }
     
-    T get_value() const {
+    const T& get_value() const {
         return stack.top()->get_value();
     }
 
+    const T& operator*() const {
+        return stack.top()->get_value();
+    }
+
+    const T* operator->() const {
+        return &stack.top()->get_value();
+    }
+
     DFSIterator& operator++() {
-        auto node = stack.top();
+        Node<T,K>* node = stack.top();
         stack.pop();
-        for (auto it = node->get_children().rbegin(); it != node->get_children().rend(); ++it) {
-            stack.push(*it);
+        const auto& children = node->get_children();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push(it->get());
+        }
+        return *this;
+    }
+
+    DFSIterator operator++(int) {
+        DFSIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    // Move past the current node without visiting its subtree
+    DFSIterator& skip_children() {
+        if (!stack.empty()) {
+            stack.pop();
         }
         return *this;
     }
@@ -0,0 +1,177 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef FLAT_TREE_HPP
+#define FLAT_TREE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <queue>
+#include "Tree.hpp"
+#include "IndexIterators.hpp"
+
+// Structure-of-arrays k-ary tree.
+// Values are stored in BFS order in one contiguous vector, and the children of node i
+// are the index range [offsets[i], offsets[i+1]) of that same vector.
+template<typename T, size_t K>
+class FlatTree {
+public:
+    using value_type = T;
+    using index_type = uint32_t;
+
+private:
+    std::vector<T> values;
+    std::vector<index_type> offsets;
+
+public:
+    FlatTree() = default;
+
+    // Flatten a pointer-based tree.
+    // Throws std::length_error when the tree has more nodes than index_type can count.
+    explicit FlatTree(const Tree<T,K>& tree) {
+        auto root = tree.getRoot();
+        if (!root) return;
+
+        std::queue<const Node<T,K>*> queue;
+        queue.push(root.get());
+        index_type next_child = 1;
+        while (!queue.empty()) {
+            const Node<T,K>* node = queue.front();
+            queue.pop();
+            values.push_back(node->get_value());
+            offsets.push_back(next_child);
+            for (const auto& child : node->get_children()) {
+                if (next_child == std::numeric_limits<index_type>::max()) {
+                    throw std::length_error("FlatTree: tree has too many nodes for index_type");
+                }
+                queue.push(child.get());
+                ++next_child;
+            }
+        }
+        offsets.push_back(next_child);
+    }
+
+    // Rebuild a pointer-based tree with the same shape and values
+    Tree<T,K> to_tree(NodeStorage storage = NodeStorage::Shared) const {
+        Tree<T,K> tree(storage);
+        if (values.empty()) return tree;
+
+        tree.add_root(Node<T,K>(values[0]));
+        std::vector<std::shared_ptr<Node<T,K>>> nodes(values.size());
+        nodes[0] = tree.getRoot();
+        for (size_t i = 0; i < values.size(); ++i) {
+            for (size_t child = child_begin(i); child < child_end(i); ++child) {
+                nodes[child] = tree.create_node(Node<T,K>(values[child]));
+                nodes[i]->add_child(nodes[child]);
+            }
+        }
+        return tree;
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+    bool empty() const {
+        return values.empty();
+    }
+
+    const T& value(size_t i) const {
+        return values[i];
+    }
+
+    size_t child_begin(size_t i) const {
+        return offsets[i];
+    }
+
+    size_t child_end(size_t i) const {
+        return offsets[i + 1];
+    }
+
+    // All values in BFS order
+    const std::vector<T>& get_values() const {
+        return values;
+    }
+
+    IndexPreOrderIterator<FlatTree> begin_pre_order() const {
+        return IndexPreOrderIterator<FlatTree>(this);
+    }
+
+    IndexPreOrderIterator<FlatTree> end_pre_order() const {
+        return IndexPreOrderIterator<FlatTree>(nullptr);
+    }
+
+    IndexPostOrderIterator<FlatTree> begin_post_order() const {
+        return IndexPostOrderIterator<FlatTree>(this);
+    }
+
+    IndexPostOrderIterator<FlatTree> end_post_order() const {
+        return IndexPostOrderIterator<FlatTree>(nullptr);
+    }
+
+    IndexInOrderIterator<FlatTree> begin_in_order() const {
+        return IndexInOrderIterator<FlatTree>(this);
+    }
+
+    IndexInOrderIterator<FlatTree> end_in_order() const {
+        return IndexInOrderIterator<FlatTree>(nullptr);
+    }
+
+    IndexBFSIterator<FlatTree> begin_bfs_scan() const {
+        return IndexBFSIterator<FlatTree>(this);
+    }
+
+    IndexBFSIterator<FlatTree> end_bfs_scan() const {
+        return IndexBFSIterator<FlatTree>(nullptr);
+    }
+
+    IndexPreOrderIterator<FlatTree> begin_dfs_scan() const {
+        return IndexPreOrderIterator<FlatTree>(this);
+    }
+
+    IndexPreOrderIterator<FlatTree> end_dfs_scan() const {
+        return IndexPreOrderIterator<FlatTree>(nullptr);
+    }
+
+    // Ranges as in Tree; deduced return types, as the iterators need this class to be complete
+    auto pre_order() const {
+        return std::ranges::subrange(begin_pre_order(), std::default_sentinel);
+    }
+
+    auto post_order() const {
+        return std::ranges::subrange(begin_post_order(), std::default_sentinel);
+    }
+
+    auto in_order() const {
+        return std::ranges::subrange(begin_in_order(), std::default_sentinel);
+    }
+
+    auto bfs() const {
+        return std::ranges::subrange(begin_bfs_scan(), std::default_sentinel);
+    }
+
+    auto dfs() const {
+        return std::ranges::subrange(begin_dfs_scan(), std::default_sentinel);
+    }
+
+    auto heap() const {
+        return std::ranges::subrange(myHeap(), std::default_sentinel);
+    }
+
+    HeapIterator<T,K> myHeap() const {
+        return HeapIterator<T,K>(values);
+    }
+
+    HeapIterator<T,K> emptyHeap() const {
+        return HeapIterator<T,K>(std::vector<T>());
+    }
+
+    template<typename Compare = std::greater<T>>
+    std::vector<T> top_k(size_t k, Compare comp = Compare()) const {
+        TopK<T,Compare> selection(k, comp);
+        for (const T& value : values) selection.push(value);
+        return selection.take();
+    }
+};
+
+#endif
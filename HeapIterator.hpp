@@ -3,32 +3,172 @@
 #define HEAP_ITERATOR_HPP
 
 #include "Node.hpp"
-// Heap iterator
-template<typename T, size_t K>
+#include "RadixSort.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// A value type can offer sort_key(), a cheap-to-compare key whose > order is the type's operator>.
+// Sorted scans then compute each key once instead of inside every comparison.
+template<typename T, typename = void>
+struct has_sort_key : std::false_type {};
+
+template<typename T>
+struct has_sort_key<T, std::void_t<decltype(std::declval<const T&>().sort_key())>> : std::true_type {};
+
+// Sort ascending by sort_key(), moving each value next to its key once
+template<typename T>
+void sort_by_key(std::vector<T>& values) {
+    using Key = decltype(std::declval<const T&>().sort_key());
+    std::vector<std::pair<Key, T>> keyed;
+    keyed.reserve(values.size());
+    for (T& value : values) {
+        Key key = value.sort_key();
+        keyed.emplace_back(key, std::move(value));
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return b.first > a.first; });
+    values.clear();
+    for (auto& entry : keyed) {
+        values.push_back(std::move(entry.second));
+    }
+}
+
+// True when a scan in Compare order can sort its values instead of comparing them: the default
+// ascending or descending order, of a number (radix_sort) or of a type with sort_key()
+template<typename T, typename Compare>
+constexpr bool sorts_without_compare = (std::is_same_v<Compare, std::greater<T>> || std::is_same_v<Compare, std::less<T>>)
+                                       && (is_radix_sortable<T> || has_sort_key<T>::value);
+
+// Sort ascending through radix_sort or sort_by_key, for the types above
+template<typename T>
+void sort_ascending(std::vector<T>& values) {
+    if constexpr (is_radix_sortable<T>) {
+        radix_sort(values);
+    } else {
+        sort_by_key(values);
+    }
+}
+
+// Tag for a heap iterator that walks a heap-ordered tree through its frontier
+struct FrontierScan {};
+inline constexpr FrontierScan frontier_scan{};
+
+// Heap iterator.
+// Compare follows std::priority_queue: the default std::greater<T> yields the smallest value first.
+template<typename T, size_t K, typename Compare = std::greater<T>>
 class HeapIterator {
 private:
+    // In the default ascending (or descending) order, numbers are radix sorted and types with
+    // sort_key() are sorted by their cached keys, instead of heapified.
+    // The sorted values are kept last-out-first, so a step is a pop_back.
+    static constexpr bool sorted = sorts_without_compare<T, Compare>;
+
     std::vector<T> heap;
+    Compare comp;
+    // Frontier mode: unvisited nodes whose parents were all yielded, as a heap ordered by value
+    std::vector<const Node<T,K>*> frontier;
+    bool use_frontier = false;
+    size_t taken = 0;
+
+    auto by_value() const {
+        return [this](const Node<T,K>* a, const Node<T,K>* b) { return comp(a->get_value(), b->get_value()); };
+    }
+
+    bool done() const {
+        return use_frontier ? frontier.empty() : heap.empty();
+    }
+
+    void order_values() {
+        if constexpr (sorted) {
+            sort_ascending(heap);
+            if constexpr (std::is_same_v<Compare, std::greater<T>>) {
+                std::reverse(heap.begin(), heap.end());
+            }
+        } else {
+            std::make_heap(heap.begin(), heap.end(), comp);
+        }
+    }
 
 public:
-    explicit HeapIterator(std::shared_ptr<Node<T,K>> root) {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    HeapIterator() = default;
+
+    explicit HeapIterator(std::shared_ptr<Node<T,K>> root, Compare comp = Compare()) : comp(comp) {
         build_heap(root);
-        std::make_heap(heap.begin(), heap.end(), std::greater<T>());
+        order_values();
+    }
+
+    // Heapify values that were already collected, e.g. from a FlatTree
+    explicit HeapIterator(std::vector<T> values, Compare comp = Compare()) : heap(std::move(values)), comp(comp) {
+        order_values();
+    }
+
+    // For a tree where no node comes out after any of its children under Compare, e.g. a min-heap.
+    // Only the frontier is kept, so the first value is ready in O(1) and each step is O(K log frontier).
+    HeapIterator(std::shared_ptr<Node<T,K>> root, FrontierScan, Compare comp = Compare()) : comp(comp), use_frontier(true) {
+        if (root) frontier.push_back(root.get());
     }
 
     bool isNotEmpty() const {
-        return !heap.empty();
+        return !done();
+    }
+
+    // Every step yields one value, so the number taken is the position
+    bool operator==(const HeapIterator& other) const {
+        return done() == other.done() && (done() || taken == other.taken);
     }
 
-    T get_value() const {
-        return heap.front();
+    bool operator==(std::default_sentinel_t) const {
+        return done();
+    }
+
+    const T& get_value() const {
+        if (use_frontier) return frontier.front()->get_value();
+        return sorted ? heap.back() : heap.front();
+    }
+
+    const T& operator*() const {
+        return get_value();
+    }
+
+    const T* operator->() const {
+        return &get_value();
     }
 
     HeapIterator& operator++() {
-        std::pop_heap(heap.begin(), heap.end(), std::greater<T>());
-        heap.pop_back();
+        if (use_frontier) {
+            const Node<T,K>* node = frontier.front();
+            std::pop_heap(frontier.begin(), frontier.end(), by_value());
+            frontier.pop_back();
+            for (const auto& child : node->get_children()) {
+                frontier.push_back(child.get());
+                std::push_heap(frontier.begin(), frontier.end(), by_value());
+            }
+        } else {
+            if constexpr (!sorted) {
+                std::pop_heap(heap.begin(), heap.end(), comp);
+            }
+            heap.pop_back();
+        }
+        ++taken;
         return *this;
     }
 
+    // Copies the remaining heap; prefer the prefix form
+    HeapIterator operator++(int) {
+        HeapIterator old = *this;
+        ++*this;
+        return old;
+    }
+
 private:
     void build_heap(std::shared_ptr<Node<T,K>> node) {
         if (node) {
@@ -39,4 +179,42 @@ private:
         }
     }
 };
+
+// Keeps the first k values a HeapIterator with the same Compare would yield, in O(n log k) time
+// and O(k) memory: a bounded heap whose top is the kept value that would come out last.
+template<typename T, typename Compare = std::greater<T>>
+class TopK {
+private:
+    std::vector<T> kept;
+    size_t k;
+    Compare comp;
+
+public:
+    explicit TopK(size_t k, Compare comp = Compare()) : k(k), comp(comp) {
+        kept.reserve(k);
+    }
+
+    void push(const T& value) {
+        if (kept.size() < k) {
+            kept.push_back(value);
+            std::push_heap(kept.begin(), kept.end(), later());
+        } else if (k > 0 && comp(kept.front(), value)) {
+            std::pop_heap(kept.begin(), kept.end(), later());
+            kept.back() = value;
+            std::push_heap(kept.begin(), kept.end(), later());
+        }
+    }
+
+    // The kept values in the order a HeapIterator would yield them
+    std::vector<T> take() {
+        std::sort_heap(kept.begin(), kept.end(), later());
+        return std::move(kept);
+    }
+
+private:
+    // True when a comes out before b, so the heap top is the value that comes out last
+    auto later() const {
+        return [this](const T& a, const T& b) { return comp(b, a); };
+    }
+};
 #endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef IMPLICIT_TREE_HPP
+#define IMPLICIT_TREE_HPP
+
+#include <vector>
+#include <algorithm>
+#include "Tree.hpp"
+#include "IndexIterators.hpp"
+
+// Pointer-free complete k-ary tree in Eytzinger layout.
+// Values are stored level by level; child c of node i is at index K*i + c + 1
+// and the parent of node i is at (i - 1) / K, so only the values take memory.
+template<typename T, size_t K>
+class ImplicitTree {
+public:
+    using value_type = T;
+
+private:
+    std::vector<T> values;
+
+public:
+    ImplicitTree() = default;
+
+    // Take values already in level order
+    explicit ImplicitTree(std::vector<T> values) : values(std::move(values)) {}
+
+    // Append the next node in level order
+    void push_back(const T& value) {
+        values.push_back(value);
+    }
+
+    void reserve(size_t n) {
+        values.reserve(n);
+    }
+
+    void clear() {
+        values.clear();
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+    bool empty() const {
+        return values.empty();
+    }
+
+    const T& value(size_t i) const {
+        return values[i];
+    }
+
+    T& value(size_t i) {
+        return values[i];
+    }
+
+    static size_t parent(size_t i) {
+        return (i - 1) / K;
+    }
+
+    static size_t child(size_t i, size_t c) {
+        return K * i + c + 1;
+    }
+
+    size_t child_begin(size_t i) const {
+        return std::min(child(i, 0), values.size());
+    }
+
+    size_t child_end(size_t i) const {
+        return std::min(child(i, K), values.size());
+    }
+
+    // All values in level (BFS) order
+    const std::vector<T>& get_values() const {
+        return values;
+    }
+
+    // Rebuild a pointer-based tree with the same shape and values
+    Tree<T,K> to_tree(NodeStorage storage = NodeStorage::Shared) const {
+        Tree<T,K> tree(storage);
+        if (values.empty()) return tree;
+
+        tree.add_root(Node<T,K>(values[0]));
+        std::vector<std::shared_ptr<Node<T,K>>> nodes(values.size());
+        nodes[0] = tree.getRoot();
+        for (size_t i = 1; i < values.size(); ++i) {
+            nodes[i] = tree.create_node(Node<T,K>(values[i]));
+            nodes[parent(i)]->add_child(nodes[i]);
+        }
+        return tree;
+    }
+
+    IndexPreOrderIterator<ImplicitTree> begin_pre_order() const {
+        return IndexPreOrderIterator<ImplicitTree>(this);
+    }
+
+    IndexPreOrderIterator<ImplicitTree> end_pre_order() const {
+        return IndexPreOrderIterator<ImplicitTree>(nullptr);
+    }
+
+    IndexPostOrderIterator<ImplicitTree> begin_post_order() const {
+        return IndexPostOrderIterator<ImplicitTree>(this);
+    }
+
+    IndexPostOrderIterator<ImplicitTree> end_post_order() const {
+        return IndexPostOrderIterator<ImplicitTree>(nullptr);
+    }
+
+    IndexInOrderIterator<ImplicitTree> begin_in_order() const {
+        return IndexInOrderIterator<ImplicitTree>(this);
+    }
+
+    IndexInOrderIterator<ImplicitTree> end_in_order() const {
+        return IndexInOrderIterator<ImplicitTree>(nullptr);
+    }
+
+    IndexBFSIterator<ImplicitTree> begin_bfs_scan() const {
+        return IndexBFSIterator<ImplicitTree>(this);
+    }
+
+    IndexBFSIterator<ImplicitTree> end_bfs_scan() const {
+        return IndexBFSIterator<ImplicitTree>(nullptr);
+    }
+
+    IndexPreOrderIterator<ImplicitTree> begin_dfs_scan() const {
+        return IndexPreOrderIterator<ImplicitTree>(this);
+    }
+
+    IndexPreOrderIterator<ImplicitTree> end_dfs_scan() const {
+        return IndexPreOrderIterator<ImplicitTree>(nullptr);
+    }
+
+    // Ranges as in Tree; deduced return types, as the iterators need this class to be complete
+    auto pre_order() const {
+        return std::ranges::subrange(begin_pre_order(), std::default_sentinel);
+    }
+
+    auto post_order() const {
+        return std::ranges::subrange(begin_post_order(), std::default_sentinel);
+    }
+
+    auto in_order() const {
+        return std::ranges::subrange(begin_in_order(), std::default_sentinel);
+    }
+
+    auto bfs() const {
+        return std::ranges::subrange(begin_bfs_scan(), std::default_sentinel);
+    }
+
+    auto dfs() const {
+        return std::ranges::subrange(begin_dfs_scan(), std::default_sentinel);
+    }
+
+    auto heap() const {
+        return std::ranges::subrange(myHeap(), std::default_sentinel);
+    }
+
+    HeapIterator<T,K> myHeap() const {
+        return HeapIterator<T,K>(values);
+    }
+
+    HeapIterator<T,K> emptyHeap() const {
+        return HeapIterator<T,K>(std::vector<T>());
+    }
+
+    template<typename Compare = std::greater<T>>
+    std::vector<T> top_k(size_t k, Compare comp = Compare()) const {
+        TopK<T,Compare> selection(k, comp);
+        for (const T& value : values) selection.push(value);
+        return selection.take();
+    }
+};
+
+#endif
@@ -3,53 +3,84 @@
 #define INORDER_ITERATOR_HPP
 
 #include "Node.hpp"
-// In-order iterator 
+#include "TraversalBuffer.hpp"
+#include <cstddef>
+#include <iterator>
+// In-order iterator.
+// Keeps raw node pointers, so advancing copies no children and touches no reference counts;
+// the tree must outlive the iterator.
 template<typename T, size_t K>
 class InOrderIterator {
 private:
-    std::stack<std::shared_ptr<Node<T,K>>> stack;
-    std::shared_ptr<Node<T,K>> current;
+    SmallStack<Node<T,K>*> stack;
+    Node<T,K>* current = nullptr;
 
-    void push_left(std::shared_ptr<Node<T,K>> node) {
+    void push_left(Node<T,K>* node) {
         while (node) {
             stack.push(node);
-            auto children = node->get_children();
-            node = (children.empty()) ? nullptr : children.front();
+            const auto& children = node->get_children();
+            node = (children.empty()) ? nullptr : children.front().get();
         }
     }
 
 public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    InOrderIterator() = default;
+
     explicit InOrderIterator(std::shared_ptr<Node<T,K>> root) {
-        push_left(root);
+        push_left(root.get());
         current = (stack.empty()) ? nullptr : stack.top();
     }
 
-    bool operator!=(const InOrderIterator& other) const {
-        return current != other.current;
+    InOrderIterator(std::shared_ptr<Node<T,K>> root, std::vector<Node<T,K>*>& scratch) : stack(scratch) {
+        push_left(root.get());
+        current = (stack.empty()) ? nullptr : stack.top();
+    }
+
+    bool operator==(const InOrderIterator& other) const {
+        return current == other.current;
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return current == nullptr;
     }
 
-    T get_value() const {
+    const T& get_value() const {
         return current->get_value();
     }
 
+    const T& operator*() const {
+        return current->get_value();
+    }
+
+    const T* operator->() const {
+        return &current->get_value();
+    }
+
     InOrderIterator& operator++() {
         if (!stack.empty()) {
-            auto node = stack.top();
+            Node<T,K>* node = stack.top();
             stack.pop();
-            auto children = node->get_children();
-            if (!children.empty()) {
-                if (children.size() == 1) {
-                    push_left(nullptr);
-                } else {
-                    for (unsigned int i = children.size()-1; i >= 1; i--) {
-                        push_left(children[i]);
-                    }
-                }
+            const auto& children = node->get_children();
+            // The first child was visited before the node; push the others, last one deepest
+            for (size_t i = children.size(); i > 1; i--) {
+                push_left(children[i - 1].get());
             }
             current = (stack.empty()) ? nullptr : stack.top();
         }
         return *this;
     }
+
+    InOrderIterator operator++(int) {
+        InOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
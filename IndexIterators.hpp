@@ -0,0 +1,278 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef INDEX_ITERATORS_HPP
+#define INDEX_ITERATORS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Iterators over trees stored in arrays in BFS order, where the children of node i
+// are the contiguous index range [child_begin(i), child_end(i)).
+// Layout must provide value_type, size(), value(i), child_begin(i) and child_end(i).
+
+// Forward iterator typedefs shared by the index iterators
+template<typename Layout>
+struct IndexIteratorTypes {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Layout::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+};
+
+// Pre-order (and DFS) iterator
+template<typename Layout>
+class IndexPreOrderIterator : public IndexIteratorTypes<Layout> {
+private:
+    const Layout* layout;
+    std::vector<size_t> stack;
+
+public:
+    IndexPreOrderIterator() : IndexPreOrderIterator(nullptr) {}
+
+    explicit IndexPreOrderIterator(const Layout* layout) : layout(layout) {
+        if (layout != nullptr && layout->size() > 0) {
+            stack.push_back(0);
+        }
+    }
+
+    bool operator==(const IndexPreOrderIterator& other) const {
+        return position() == other.position();
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return stack.empty();
+    }
+
+    const typename Layout::value_type& get_value() const {
+        return layout->value(stack.back());
+    }
+
+    const typename Layout::value_type& operator*() const {
+        return layout->value(stack.back());
+    }
+
+    const typename Layout::value_type* operator->() const {
+        return &layout->value(stack.back());
+    }
+
+    IndexPreOrderIterator& operator++() {
+        size_t node = stack.back();
+        stack.pop_back();
+        for (size_t child = layout->child_end(node); child > layout->child_begin(node); --child) {
+            stack.push_back(child - 1);
+        }
+        return *this;
+    }
+
+    IndexPreOrderIterator operator++(int) {
+        IndexPreOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+private:
+    // Index of the current node, SIZE_MAX once done
+    size_t position() const {
+        return (stack.empty() ? SIZE_MAX : stack.back());
+    }
+};
+
+// Post-order iterator, keeping (node, next child) frames so each step is O(1) amortized
+template<typename Layout>
+class IndexPostOrderIterator : public IndexIteratorTypes<Layout> {
+private:
+    struct Frame {
+        size_t node;
+        size_t next_child;
+    };
+
+    const Layout* layout;
+    std::vector<Frame> stack;
+
+    void descend(size_t node) {
+        while (true) {
+            size_t first = layout->child_begin(node);
+            bool leaf = first == layout->child_end(node);
+            stack.push_back({node, first + 1});
+            if (leaf) break;
+            node = first;
+        }
+    }
+
+public:
+    IndexPostOrderIterator() : IndexPostOrderIterator(nullptr) {}
+
+    explicit IndexPostOrderIterator(const Layout* layout) : layout(layout) {
+        if (layout != nullptr && layout->size() > 0) {
+            descend(0);
+        }
+    }
+
+    bool operator==(const IndexPostOrderIterator& other) const {
+        return position() == other.position();
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return stack.empty();
+    }
+
+    const typename Layout::value_type& get_value() const {
+        return layout->value(stack.back().node);
+    }
+
+    const typename Layout::value_type& operator*() const {
+        return layout->value(stack.back().node);
+    }
+
+    const typename Layout::value_type* operator->() const {
+        return &layout->value(stack.back().node);
+    }
+
+    IndexPostOrderIterator& operator++() {
+        stack.pop_back();
+        if (!stack.empty()) {
+            Frame& parent = stack.back();
+            if (parent.next_child < layout->child_end(parent.node)) {
+                descend(parent.next_child++);
+            }
+        }
+        return *this;
+    }
+
+    IndexPostOrderIterator operator++(int) {
+        IndexPostOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+private:
+    // Index of the current node, SIZE_MAX once done
+    size_t position() const {
+        return (stack.empty() ? SIZE_MAX : stack.back().node);
+    }
+};
+
+// In-order iterator: first child subtree, then the node, then the remaining child subtrees
+template<typename Layout>
+class IndexInOrderIterator : public IndexIteratorTypes<Layout> {
+private:
+    const Layout* layout;
+    std::vector<size_t> stack;
+
+    void push_left(size_t node) {
+        while (true) {
+            stack.push_back(node);
+            if (layout->child_begin(node) == layout->child_end(node)) break;
+            node = layout->child_begin(node);
+        }
+    }
+
+public:
+    IndexInOrderIterator() : IndexInOrderIterator(nullptr) {}
+
+    explicit IndexInOrderIterator(const Layout* layout) : layout(layout) {
+        if (layout != nullptr && layout->size() > 0) {
+            push_left(0);
+        }
+    }
+
+    bool operator==(const IndexInOrderIterator& other) const {
+        return position() == other.position();
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return stack.empty();
+    }
+
+    const typename Layout::value_type& get_value() const {
+        return layout->value(stack.back());
+    }
+
+    const typename Layout::value_type& operator*() const {
+        return layout->value(stack.back());
+    }
+
+    const typename Layout::value_type* operator->() const {
+        return &layout->value(stack.back());
+    }
+
+    IndexInOrderIterator& operator++() {
+        size_t node = stack.back();
+        stack.pop_back();
+        size_t first = layout->child_begin(node);
+        for (size_t child = layout->child_end(node); child > first + 1; --child) {
+            push_left(child - 1);
+        }
+        return *this;
+    }
+
+    IndexInOrderIterator operator++(int) {
+        IndexInOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+private:
+    // Index of the current node, SIZE_MAX once done
+    size_t position() const {
+        return (stack.empty() ? SIZE_MAX : stack.back());
+    }
+};
+
+// BFS iterator: the layout is already in BFS order, so this is a linear scan
+template<typename Layout>
+class IndexBFSIterator : public IndexIteratorTypes<Layout> {
+private:
+    const Layout* layout;
+    size_t index;
+
+public:
+    IndexBFSIterator() : IndexBFSIterator(nullptr) {}
+
+    explicit IndexBFSIterator(const Layout* layout) : layout(layout), index(0) {}
+
+    bool operator==(const IndexBFSIterator& other) const {
+        return position() == other.position();
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return remaining() == 0;
+    }
+
+    const typename Layout::value_type& get_value() const {
+        return layout->value(index);
+    }
+
+    const typename Layout::value_type& operator*() const {
+        return layout->value(index);
+    }
+
+    const typename Layout::value_type* operator->() const {
+        return &layout->value(index);
+    }
+
+    IndexBFSIterator& operator++() {
+        ++index;
+        return *this;
+    }
+
+    IndexBFSIterator operator++(int) {
+        IndexBFSIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+private:
+    size_t remaining() const {
+        return (layout == nullptr) ? 0 : layout->size() - index;
+    }
+
+    // Index of the current node, SIZE_MAX once done
+    size_t position() const {
+        return (remaining() == 0 ? SIZE_MAX : index);
+    }
+};
+
+#endif
@@ -0,0 +1,65 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef LEVEL_ITERATOR_HPP
+#define LEVEL_ITERATOR_HPP
+
+#include <vector>
+#include "Node.hpp"
+
+// Level-synchronous BFS: each step yields a whole level of the tree.
+// The current and next frontiers are two raw pointer vectors that are swapped between levels,
+// so their capacity is reused and no reference counts are touched.
+template<typename T, size_t K>
+class LevelIterator {
+private:
+    std::vector<Node<T,K>*> current;
+    std::vector<Node<T,K>*> next;
+    size_t level_depth = 0;
+
+public:
+    using const_iterator = typename std::vector<Node<T,K>*>::const_iterator;
+
+    explicit LevelIterator(std::shared_ptr<Node<T,K>> root) {
+        if (root) current.push_back(root.get());
+    }
+
+    bool operator!=(const LevelIterator& other) const {
+        return !current.empty() || !other.current.empty();
+    }
+
+    // Depth of the current level, 0 for the root
+    size_t depth() const {
+        return level_depth;
+    }
+
+    // Number of nodes in the current level
+    size_t size() const {
+        return current.size();
+    }
+
+    // The nodes of the current level, left to right
+    const_iterator begin_level() const {
+        return current.begin();
+    }
+
+    const_iterator end_level() const {
+        return current.end();
+    }
+
+    const std::vector<Node<T,K>*>& level() const {
+        return current;
+    }
+
+    LevelIterator& operator++() {
+        next.clear();
+        for (Node<T,K>* node : current) {
+            for (const auto& child : node->get_children()) {
+                next.push_back(child.get());
+            }
+        }
+        current.swap(next);
+        ++level_depth;
+        return *this;
+    }
+};
+
+#endif
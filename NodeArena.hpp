@@ -0,0 +1,116 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef NODE_ARENA_HPP
+#define NODE_ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Bump allocator that carves node storage out of contiguous slabs.
+// Individual allocations are never returned; the slabs are freed all at once with the arena.
+// The tree that allocates from an arena retires it when cleared or destroyed, and the arena
+// deletes itself once it is retired and every node carved from it is gone.
+class NodeArena {
+private:
+    static constexpr size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+    // Added to the live count until retire(), so it cannot reach zero while the tree still allocates
+    static constexpr size_t RETIRE_BIAS = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+
+    std::vector<std::unique_ptr<unsigned char[]>> slabs;
+    size_t slab_size;
+    unsigned char* cursor = nullptr;
+    size_t remaining = 0;
+    size_t allocated = 0;                       // only touched by the owning tree
+    std::atomic<size_t> balance{RETIRE_BIAS};   // RETIRE_BIAS minus deallocations, then live allocations
+
+    void add_slab(size_t min_bytes) {
+        size_t bytes = (min_bytes > slab_size) ? min_bytes : slab_size;
+        slabs.emplace_back(new unsigned char[bytes]);
+        cursor = slabs.back().get();
+        remaining = bytes;
+    }
+
+    ~NodeArena() = default;
+
+public:
+    explicit NodeArena(size_t slab_size = DEFAULT_SLAB_SIZE) : slab_size(slab_size) {}
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        if (cursor == nullptr || padding + bytes > remaining) {
+            add_slab(bytes + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        }
+        void* result = cursor + padding;
+        cursor += padding + bytes;
+        remaining -= padding + bytes;
+        ++allocated;
+        return result;
+    }
+
+    // Called once per allocation when its node is destroyed, from any thread
+    void deallocate() {
+        if (balance.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    // Called once by the owning tree; the arena is gone on return unless nodes outlive the tree
+    void retire() {
+        size_t delta = allocated - RETIRE_BIAS;
+        if (balance.fetch_add(delta, std::memory_order_acq_rel) + delta == 0) delete this;
+    }
+
+    size_t slab_count() const {
+        return slabs.size();
+    }
+};
+
+// Deleter for the tree's owning pointer to its arena
+struct RetireArena {
+    void operator()(NodeArena* arena) const {
+        arena->retire();
+    }
+};
+
+// Minimal allocator handing out arena memory, used with std::allocate_shared.
+// Each control block keeps a copy, so it holds only a raw pointer; deallocate() gives nothing
+// back and only counts the node as gone.
+template<typename U>
+class ArenaAllocator {
+private:
+    NodeArena* arena;
+
+    template<typename V> friend class ArenaAllocator;
+
+public:
+    using value_type = U;
+
+    explicit ArenaAllocator(NodeArena* arena) : arena(arena) {}
+
+    template<typename V>
+    ArenaAllocator(const ArenaAllocator<V>& other) : arena(other.arena) {}
+
+    U* allocate(size_t n) {
+        return static_cast<U*>(arena->allocate(n * sizeof(U), alignof(U)));
+    }
+
+    void deallocate(U*, size_t) {
+        arena->deallocate();
+    }
+
+    template<typename V>
+    bool operator==(const ArenaAllocator<V>& other) const {
+        return arena == other.arena;
+    }
+
+    template<typename V>
+    bool operator!=(const ArenaAllocator<V>& other) const {
+        return arena != other.arena;
+    }
+};
+
+#endif
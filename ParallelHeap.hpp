@@ -0,0 +1,185 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef PARALLEL_HEAP_HPP
+#define PARALLEL_HEAP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "HeapIterator.hpp"
+#include "Node.hpp"
+#include "TraversalBuffer.hpp"
+
+// Subtrees handed out per worker thread, so uneven subtrees still balance
+constexpr size_t SUBTREES_PER_THREAD = 8;
+
+// Levels split off the top at most, so a chain or a skewed tree is not walked into the top run serially
+constexpr size_t MAX_SPLIT_LEVELS = 32;
+
+// Sort the values under root into sorted runs on several threads.
+// The top levels are split off until there are enough subtrees, workers take subtrees one at a
+// time, and each worker sorts what it collected. The top levels form one more run.
+// Runs are sorted so that a run's front comes out first under Compare.
+// An exception thrown on a worker, by Compare or by copying a value, is rethrown once all have joined.
+template<typename T, size_t K, typename Compare>
+std::vector<std::vector<T>> sorted_runs(const Node<T,K>* root, size_t threads, Compare comp) {
+    std::vector<std::vector<T>> runs;
+    if (root == nullptr) return runs;
+    // Runs are sorted the way HeapIterator would sort them, so one thread is as fast as myHeap()
+    auto sort_run = [&comp](std::vector<T>& run) {
+        if constexpr (sorts_without_compare<T, Compare>) {
+            sort_ascending(run);
+            if constexpr (std::is_same_v<Compare, std::less<T>>) {
+                std::reverse(run.begin(), run.end());
+            }
+        } else {
+            std::sort(run.begin(), run.end(), [&comp](const T& a, const T& b) { return comp(b, a); });
+        }
+    };
+
+    // Split the top of the tree level by level until there are enough subtrees
+    std::vector<T> top;
+    std::vector<const Node<T,K>*> subtrees{root};
+    const size_t wanted = (threads > 1) ? threads * SUBTREES_PER_THREAD : 1;
+    for (size_t level = 0; subtrees.size() < wanted && level < MAX_SPLIT_LEVELS; ++level) {
+        std::vector<const Node<T,K>*> next;
+        for (const Node<T,K>* node : subtrees) {
+            for (const auto& child : node->get_children()) next.push_back(child.get());
+        }
+        if (next.empty()) break;
+        for (const Node<T,K>* node : subtrees) top.push_back(node->get_value());
+        subtrees.swap(next);
+    }
+
+    threads = std::max<size_t>(1, std::min(threads, subtrees.size()));
+    runs.resize(threads);
+    std::atomic<size_t> next_subtree{0};
+    auto work = [&](std::vector<T>& run) {
+        SmallStack<const Node<T,K>*> pending;
+        for (size_t i = next_subtree++; i < subtrees.size(); i = next_subtree++) {
+            pending.push(subtrees[i]);
+            while (!pending.empty()) {
+                const Node<T,K>* node = pending.top();
+                pending.pop();
+                run.push_back(node->get_value());
+                for (const auto& child : node->get_children()) pending.push(child.get());
+            }
+        }
+        sort_run(run);
+    };
+
+    std::vector<std::exception_ptr> errors(threads);
+    auto guarded_work = [&](size_t t) {
+        try {
+            work(runs[t]);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(guarded_work, t);
+    }
+    guarded_work(0);
+    for (auto& worker : workers) worker.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    if (!top.empty()) {
+        sort_run(top);
+        runs.push_back(std::move(top));
+    }
+    return runs;
+}
+
+// Sorted scan that lazily k-way merges the runs from sorted_runs.
+// The runs are shared and never change, so copying the iterator copies only its cursors.
+template<typename T, typename Compare = std::greater<T>>
+class MergeHeapIterator {
+private:
+    struct Cursor {
+        size_t run;
+        size_t position;
+    };
+
+    std::shared_ptr<const std::vector<std::vector<T>>> runs;
+    std::vector<Cursor> cursors;    // heap: the cursor at the front comes out first
+    Compare comp;
+    size_t taken = 0;
+
+    const T& at(const Cursor& cursor) const {
+        return (*runs)[cursor.run][cursor.position];
+    }
+
+    auto by_value() const {
+        return [this](const Cursor& a, const Cursor& b) { return comp(at(a), at(b)); };
+    }
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    MergeHeapIterator() = default;
+
+    explicit MergeHeapIterator(std::vector<std::vector<T>> sorted, Compare comp = Compare())
+        : runs(std::make_shared<const std::vector<std::vector<T>>>(std::move(sorted))), comp(comp) {
+        for (size_t run = 0; run < runs->size(); ++run) {
+            if (!(*runs)[run].empty()) cursors.push_back({run, 0});
+        }
+        std::make_heap(cursors.begin(), cursors.end(), by_value());
+    }
+
+    bool isNotEmpty() const {
+        return !cursors.empty();
+    }
+
+    bool operator==(const MergeHeapIterator& other) const {
+        return cursors.empty() == other.cursors.empty() && (cursors.empty() || taken == other.taken);
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return cursors.empty();
+    }
+
+    const T& get_value() const {
+        return at(cursors.front());
+    }
+
+    const T& operator*() const {
+        return at(cursors.front());
+    }
+
+    const T* operator->() const {
+        return &at(cursors.front());
+    }
+
+    MergeHeapIterator& operator++() {
+        std::pop_heap(cursors.begin(), cursors.end(), by_value());
+        Cursor& cursor = cursors.back();
+        if (++cursor.position < (*runs)[cursor.run].size()) {
+            std::push_heap(cursors.begin(), cursors.end(), by_value());
+        } else {
+            cursors.pop_back();
+        }
+        ++taken;
+        return *this;
+    }
+
+    MergeHeapIterator operator++(int) {
+        MergeHeapIterator old = *this;
+        ++*this;
+        return old;
+    }
+};
+
+#endif
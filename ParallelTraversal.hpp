@@ -0,0 +1,125 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef PARALLEL_TRAVERSAL_HPP
+#define PARALLEL_TRAVERSAL_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Tree.hpp"
+#include "ThreadPool.hpp"
+
+// Nodes a task visits between checks for idle threads.
+// A subtree smaller than this always finishes inline in the task that reached it.
+constexpr size_t SPLIT_CHECK_INTERVAL = 64;
+
+// Walk the subtree under node depth first, calling visit on each value.
+// Every SPLIT_CHECK_INTERVAL nodes, if a thread is idle, the oldest pending subtree is handed to
+// the pool as a new task; it is the shallowest one, so usually the largest. The new task splits
+// itself the same way, so a large subtree keeps being divided while a small one runs inline.
+// make_visitor gives each task its own visitor, whose finish() runs when the task is done.
+template<typename T, size_t K, typename MakeVisitor>
+void split_walk(const Node<T,K>* node, const MakeVisitor& make_visitor, WorkStealingPool& pool, TaskGroup& group) {
+    auto visitor = make_visitor();
+    std::vector<const Node<T,K>*> pending{node};
+    size_t since_check = 0;
+    while (!pending.empty()) {
+        const Node<T,K>* current = pending.back();
+        pending.pop_back();
+        visitor(current->get_value());
+        const auto& children = current->get_children();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            pending.push_back(it->get());
+        }
+        if (++since_check == SPLIT_CHECK_INTERVAL) {
+            since_check = 0;
+            if (pending.size() > 1 && pool.wants_work()) {
+                const Node<T,K>* oldest = pending.front();
+                pending.erase(pending.begin());
+                pool.spawn(group, [oldest, &make_visitor, &pool, &group] {
+                    split_walk(oldest, make_visitor, pool, group);
+                });
+            }
+        }
+    }
+    visitor.finish();
+}
+
+// Run the split walk from root and wait for every task it spawned
+template<typename T, size_t K, typename MakeVisitor>
+void parallel_walk(const Node<T,K>* root, const MakeVisitor& make_visitor, WorkStealingPool& pool) {
+    if (root == nullptr) return;
+    TaskGroup group;
+    pool.spawn(group, [root, &make_visitor, &pool, &group] {
+        split_walk(root, make_visitor, pool, group);
+    });
+    pool.wait(group);
+}
+
+// Call f on every value of the tree on the threads of pool.
+// f runs concurrently and in no particular order, so it must be safe to call from several threads.
+// The first exception thrown by f is rethrown once every task has stopped.
+template<typename T, size_t K, typename F>
+void parallel_for_each(const Tree<T,K>& tree, F f, WorkStealingPool& pool = default_pool()) {
+    struct Visitor {
+        F* f;
+        void operator()(const T& value) { (*f)(value); }
+        void finish() {}
+    };
+    auto make_visitor = [&f] { return Visitor{&f}; };
+    parallel_walk(tree.getRoot().get(), make_visitor, pool);
+}
+
+// Reduce the tree on the threads of pool, like TBB's parallel_reduce(range, identity, fold, combine).
+// Each task starts a partial result from identity and folds its values into it with fold(R, const T&);
+// the partials are then merged with combine(R, R). Tasks cover the values in no particular order,
+// so combine must be associative and commutative, and identity must be its identity.
+template<typename T, size_t K, typename R, typename Fold, typename Combine>
+    requires (!std::is_same_v<std::decay_t<Combine>, WorkStealingPool>)
+R parallel_reduce(const Tree<T,K>& tree, const R& identity, Fold fold, Combine combine, WorkStealingPool& pool = default_pool()) {
+    std::mutex total_lock;
+    R total = identity;
+
+    struct Visitor {
+        Fold* fold;
+        Combine* combine;
+        std::mutex* total_lock;
+        R* total;
+        R partial;
+
+        void operator()(const T& value) {
+            partial = (*fold)(std::move(partial), value);
+        }
+
+        void finish() {
+            std::lock_guard<std::mutex> guard(*total_lock);
+            *total = (*combine)(std::move(*total), std::move(partial));
+        }
+    };
+    auto make_visitor = [&] { return Visitor{&fold, &combine, &total_lock, &total, identity}; };
+    parallel_walk(tree.getRoot().get(), make_visitor, pool);
+    return total;
+}
+
+// Combine init and every value of the tree with op, like std::reduce: op folds values into partial
+// results and merges the partials, so it must be associative and commutative and accept (R, T) and (R, R).
+// A reduction whose fold differs from its combine, such as counting, needs the form above.
+template<typename T, size_t K, typename R, typename Op>
+R parallel_reduce(const Tree<T,K>& tree, R init, Op op, WorkStealingPool& pool = default_pool()) {
+    static_assert(std::is_convertible_v<const T&, R>,
+                  "parallel_reduce(tree, init, op) seeds partials with values; use parallel_reduce(tree, identity, fold, combine)");
+    // A task's partial starts from its first value, since op has no known identity
+    auto fold = [&op](std::optional<R> partial, const T& value) {
+        return std::optional<R>(partial ? op(std::move(*partial), value) : R(value));
+    };
+    auto combine = [&op](std::optional<R> a, std::optional<R> b) {
+        if (a && b) return std::optional<R>(op(std::move(*a), std::move(*b)));
+        return a ? a : b;
+    };
+    std::optional<R> total = parallel_reduce(tree, std::optional<R>(), fold, combine, pool);
+    return total ? op(std::move(init), std::move(*total)) : init;
+}
+
+#endif
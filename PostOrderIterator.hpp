@@ -3,12 +3,35 @@
 #define POSTORDER_ITERATOR_HPP
 
 #include "Node.hpp"
-// Post-order iterator
+#include "TraversalBuffer.hpp"
+#include <cstddef>
+#include <iterator>
+
+// Post-order stack frame: a node and the index of its next child to visit
+template<typename T, size_t K>
+struct PostOrderFrame {
+    Node<T,K>* node;
+    size_t next_child;
+};
+
+// Post-order iterator.
+// Each stack frame remembers which child of its node comes next, so advancing never
+// searches the siblings and is O(1) amortized even for wide trees.
 template<typename T, size_t K>
 class PostOrderIterator {
 private:
-    std::stack<std::shared_ptr<Node<T,K>>> stack;
-    std::shared_ptr<Node<T,K>> current;
+    SmallStack<PostOrderFrame<T,K>> stack;
+    Node<T,K>* current = nullptr;
+
+    // Push node and its chain of first children; the deepest one is visited first
+    void descend(Node<T,K>* node) {
+        while (true) {
+            stack.push({node, 1});
+            const auto& children = node->get_children();
+            if (children.empty()) break;
+            node = children.front().get();
+        }
+    }
 
     void advance() {
         if (stack.empty()) {
@@ -16,63 +39,78 @@ private:
             return;
         }
 
-        auto node = stack.top();
-        stack.pop();                
-
-        bool lastChildWasProcessed = false;
-        if (!stack.empty()) {
-            auto parent = stack.top();
-            auto& siblings = parent->get_children();
-            auto it = std::find(siblings.begin(), siblings.end(), node);
-
-            if (it != siblings.end() && ++it != siblings.end()) {
-                node = *it;
-                while (!node->get_children().empty()) {
-                    stack.push(node);
-                    node = node->get_children().front();
-                }
-                stack.push(node);
-            } else {
-                lastChildWasProcessed = true;    
-            }
-        } else {
+        stack.pop();
+        if (stack.empty()) {
             current = nullptr;
             return;
         }
 
-        if (lastChildWasProcessed) {
-            // if the last child was processed, process the parent.
-            current = stack.top();
-        } else {
-            current = node;
+        PostOrderFrame<T,K>& parent = stack.top();
+        const auto& siblings = parent.node->get_children();
+        if (parent.next_child < siblings.size()) {
+            descend(siblings[parent.next_child++].get());
         }
+        // Either the next sibling's deepest first descendant, or the parent once all its children are done
+        current = stack.top().node;
     }
 
 public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    PostOrderIterator() = default;
+
     explicit PostOrderIterator(std::shared_ptr<Node<T,K>> root) {
         if (root) {
-            stack.push(root);
-            while (!stack.empty() && !stack.top()->get_children().empty()) {
-                stack.push(stack.top()->get_children().front());
-            }
-            current = stack.top();
+            descend(root.get());
+            current = stack.top().node;
         } else {
             current = nullptr;
         }
     }
 
-    bool operator!=(const PostOrderIterator& other) const {
-        return current != other.current;
+    PostOrderIterator(std::shared_ptr<Node<T,K>> root, std::vector<PostOrderFrame<T,K>>& scratch) : stack(scratch) {
+        if (root) {
+            descend(root.get());
+            current = stack.top().node;
+        } else {
+            current = nullptr;
+        }
+    }
+
+    bool operator==(const PostOrderIterator& other) const {
+        return current == other.current;
     }
 
-    T get_value() const {
+    bool operator==(std::default_sentinel_t) const {
+        return current == nullptr;
+    }
+
+    const T& get_value() const {
         return current->get_value();
     }
 
+    const T& operator*() const {
+        return current->get_value();
+    }
+
+    const T* operator->() const {
+        return &current->get_value();
+    }
+
     PostOrderIterator& operator++() {
         advance();        
         return *this;
     }
+
+    PostOrderIterator operator++(int) {
+        PostOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -3,41 +3,92 @@
 #define PREORDER_ITERATOR_HPP
 
 #include "Node.hpp"
+#include "TraversalBuffer.hpp"
+#include <cstddef>
+#include <iterator>
 
-// Pre-order iterator
+// Pre-order iterator.
+// Keeps raw node pointers, so advancing copies no children and touches no reference counts;
+// the tree must outlive the iterator.
 template<typename T, size_t K>
 class PreOrderIterator {
 private:
-    std::stack<std::shared_ptr<Node<T,K>>> stack;
+    SmallStack<Node<T,K>*> stack;
+
+    Node<T,K>* position() const {
+        return stack.empty() ? nullptr : stack.top();
+    }
 
 public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    PreOrderIterator() = default;
+
     explicit PreOrderIterator(std::shared_ptr<Node<T,K>> root) {
         if (root != nullptr) {
-            stack.push(root);
+            stack.push(root.get());
+        }
+    }
+
+    // Spill the stack into a caller-owned scratch buffer, so repeated traversals allocate nothing
+    PreOrderIterator(std::shared_ptr<Node<T,K>> root, std::vector<Node<T,K>*>& scratch) : stack(scratch) {
+        if (root != nullptr) {
+            stack.push(root.get());
         }
     }
 
-    bool operator!=(const PreOrderIterator& other) const {
-        return !stack.empty() || !other.stack.empty();                
+    // Equal when at the same node; compare only iterators over the same tree
+    bool operator==(const PreOrderIterator& other) const {
+        return position() == other.position();
+    }
+
+    bool operator==(std::default_sentinel_t) const {
+        return stack.empty();
     }
 
-    T get_value() const {
+    const T& get_value() const {
         return stack.top()->get_value();
     }
 
+    const T& operator*() const {
+        return stack.top()->get_value();
+    }
+
+    const T* operator->() const {
+        return &stack.top()->get_value();
+    }
+
     PreOrderIterator& operator++() {
         if (stack.empty()) {
             return *this;
         }
 
-        auto node = stack.top();
+        Node<T,K>* node = stack.top();
         stack.pop();
-        auto children = node->get_children();
+        const auto& children = node->get_children();
         
         for (auto it = children.rbegin(); it != children.rend(); ++it) {
-            stack.push(*it);
+            stack.push(it->get());
         }
         return *this;        
     }
+
+    PreOrderIterator operator++(int) {
+        PreOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    // Move past the current node without visiting its subtree
+    PreOrderIterator& skip_children() {
+        if (!stack.empty()) {
+            stack.pop();
+        }
+        return *this;
+    }
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,92 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Types radix_sort handles: integers and IEEE float/double, not bool
+template<typename T>
+constexpr bool is_radix_sortable = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+                                   || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Below this many values std::sort is faster than the byte passes
+constexpr size_t RADIX_SORT_MIN = 256;
+
+// Unsigned integer of the same size as T
+template<size_t Bytes> struct RadixKeyOf;
+template<> struct RadixKeyOf<1> { using type = uint8_t; };
+template<> struct RadixKeyOf<2> { using type = uint16_t; };
+template<> struct RadixKeyOf<4> { using type = uint32_t; };
+template<> struct RadixKeyOf<8> { using type = uint64_t; };
+
+// Map a value to an unsigned key whose unsigned order is the value's order.
+// Signed integers flip the sign bit; floating point flips every bit of negatives
+// and only the sign bit of the rest.
+template<typename T>
+typename RadixKeyOf<sizeof(T)>::type radix_key(T value) {
+    using Key = typename RadixKeyOf<sizeof(T)>::type;
+    constexpr Key sign = Key(1) << (sizeof(T) * 8 - 1);
+    Key key;
+    std::memcpy(&key, &value, sizeof(T));
+    if constexpr (std::is_floating_point_v<T>) {
+        return (key & sign) ? Key(~key) : Key(key | sign);
+    } else if constexpr (std::is_signed_v<T>) {
+        return key ^ sign;
+    } else {
+        return key;
+    }
+}
+
+// Sort ascending with an LSD radix sort, one pass per byte of the key.
+// Passes where every value shares the byte are skipped.
+template<typename T>
+void radix_sort(std::vector<T>& values) {
+    static_assert(is_radix_sortable<T>, "radix_sort needs an integer, float or double");
+    if (values.size() < RADIX_SORT_MIN) {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    using Key = typename RadixKeyOf<sizeof(T)>::type;
+    constexpr size_t passes = sizeof(T);
+    std::vector<std::array<size_t, 256>> counts(passes);
+    for (auto& count : counts) count.fill(0);
+
+    std::vector<Key> keys(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        keys[i] = radix_key(values[i]);
+        for (size_t pass = 0; pass < passes; ++pass) {
+            ++counts[pass][(keys[i] >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    std::vector<Key> sorted_keys(values.size());
+    std::vector<T> sorted_values(values.size());
+    for (size_t pass = 0; pass < passes; ++pass) {
+        auto& count = counts[pass];
+        if (std::find(count.begin(), count.end(), values.size()) != count.end()) {
+            continue;
+        }
+        size_t offset = 0;
+        for (auto& bucket : count) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+            size_t slot = count[(keys[i] >> (pass * 8)) & 0xFF]++;
+            sorted_keys[slot] = keys[i];
+            sorted_values[slot] = values[i];
+        }
+        keys.swap(sorted_keys);
+        values.swap(sorted_values);
+    }
+}
+
+#endif
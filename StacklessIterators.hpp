@@ -0,0 +1,205 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef STACKLESS_ITERATORS_HPP
+#define STACKLESS_ITERATORS_HPP
+
+#include "Node.hpp"
+#include <cstddef>
+#include <iterator>
+
+// Iterators that walk the parent links set by Node::add_child instead of keeping a stack,
+// so each one is two pointers in size whatever the depth of the tree.
+// The root may be a shallow copy of another node that shares its children (Node's copy constructor),
+// so climbing checks for the iteration root first instead of trusting its children's links.
+
+// Shared up and down moves, bounded by the iteration root
+template<typename T, size_t K>
+class ParentWalk {
+protected:
+    Node<T,K>* root;
+    Node<T,K>* current;
+
+    explicit ParentWalk(Node<T,K>* root = nullptr) : root(root), current(nullptr) {}
+
+    Node<T,K>* parent_of(Node<T,K>* node) const {
+        size_t index = node->get_child_index();
+        const auto& siblings = root->get_children();
+        if (index < siblings.size() && siblings[index].get() == node) {
+            return root;
+        }
+        return node->get_parent();
+    }
+
+    // Next child of node's parent, or nullptr if node is the last one
+    static Node<T,K>* next_sibling(Node<T,K>* parent, Node<T,K>* node) {
+        size_t next = node->get_child_index() + 1;
+        const auto& siblings = parent->get_children();
+        return (next < siblings.size()) ? siblings[next].get() : nullptr;
+    }
+
+    // Follow first children down to a leaf
+    static Node<T,K>* first_leaf(Node<T,K>* node) {
+        while (!node->get_children().empty()) {
+            node = node->get_children().front().get();
+        }
+        return node;
+    }
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    bool operator==(std::default_sentinel_t) const {
+        return current == nullptr;
+    }
+
+    const T& get_value() const {
+        return current->get_value();
+    }
+
+    const T& operator*() const {
+        return current->get_value();
+    }
+
+    const T* operator->() const {
+        return &current->get_value();
+    }
+};
+
+template<typename T, size_t K>
+class StacklessPreOrderIterator : public ParentWalk<T,K> {
+private:
+    using ParentWalk<T,K>::root;
+    using ParentWalk<T,K>::current;
+
+public:
+    using ParentWalk<T,K>::operator==;
+
+    StacklessPreOrderIterator() = default;
+
+    explicit StacklessPreOrderIterator(Node<T,K>* root) : ParentWalk<T,K>(root) {
+        current = root;
+    }
+
+    bool operator==(const StacklessPreOrderIterator& other) const {
+        return current == other.current;
+    }
+
+    StacklessPreOrderIterator& operator++() {
+        const auto& children = current->get_children();
+        if (!children.empty()) {
+            current = children.front().get();
+            return *this;
+        }
+        // Climb until some ancestor has a next sibling
+        for (Node<T,K>* node = current; node != root;) {
+            Node<T,K>* parent = this->parent_of(node);
+            Node<T,K>* sibling = this->next_sibling(parent, node);
+            if (sibling) {
+                current = sibling;
+                return *this;
+            }
+            node = parent;
+        }
+        current = nullptr;
+        return *this;
+    }
+
+    StacklessPreOrderIterator operator++(int) {
+        StacklessPreOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+};
+
+template<typename T, size_t K>
+class StacklessPostOrderIterator : public ParentWalk<T,K> {
+private:
+    using ParentWalk<T,K>::root;
+    using ParentWalk<T,K>::current;
+
+public:
+    using ParentWalk<T,K>::operator==;
+
+    StacklessPostOrderIterator() = default;
+
+    explicit StacklessPostOrderIterator(Node<T,K>* root) : ParentWalk<T,K>(root) {
+        current = root ? this->first_leaf(root) : nullptr;
+    }
+
+    bool operator==(const StacklessPostOrderIterator& other) const {
+        return current == other.current;
+    }
+
+    StacklessPostOrderIterator& operator++() {
+        if (current == root) {
+            current = nullptr;
+            return *this;
+        }
+        Node<T,K>* parent = this->parent_of(current);
+        Node<T,K>* sibling = this->next_sibling(parent, current);
+        current = sibling ? this->first_leaf(sibling) : parent;
+        return *this;
+    }
+
+    StacklessPostOrderIterator operator++(int) {
+        StacklessPostOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+};
+
+// In-order: first child subtree, then the node, then the remaining child subtrees
+template<typename T, size_t K>
+class StacklessInOrderIterator : public ParentWalk<T,K> {
+private:
+    using ParentWalk<T,K>::root;
+    using ParentWalk<T,K>::current;
+
+public:
+    using ParentWalk<T,K>::operator==;
+
+    StacklessInOrderIterator() = default;
+
+    explicit StacklessInOrderIterator(Node<T,K>* root) : ParentWalk<T,K>(root) {
+        current = root ? this->first_leaf(root) : nullptr;
+    }
+
+    bool operator==(const StacklessInOrderIterator& other) const {
+        return current == other.current;
+    }
+
+    StacklessInOrderIterator& operator++() {
+        const auto& children = current->get_children();
+        if (children.size() > 1) {
+            current = this->first_leaf(children[1].get());
+            return *this;
+        }
+        // The current subtree is finished; climb to the first ancestor with work left
+        for (Node<T,K>* node = current; node != root;) {
+            Node<T,K>* parent = this->parent_of(node);
+            if (node->get_child_index() == 0) {
+                current = parent;
+                return *this;
+            }
+            Node<T,K>* sibling = this->next_sibling(parent, node);
+            if (sibling) {
+                current = this->first_leaf(sibling);
+                return *this;
+            }
+            node = parent;
+        }
+        current = nullptr;
+        return *this;
+    }
+
+    StacklessInOrderIterator operator++(int) {
+        StacklessInOrderIterator old = *this;
+        ++*this;
+        return old;
+    }
+};
+
+#endif
@@ -3,6 +3,15 @@
 #include "doctest.h"
 #include "Tree.hpp"
 #include "Complex.hpp"
+#include "FlatTree.hpp"
+#include "ImplicitTree.hpp"
+#include "ComplexArray.hpp"
+#include "ParallelTraversal.hpp"
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <ranges>
 
 using namespace std;
 
@@ -398,3 +407,1109 @@ TEST_CASE("20 - Test Heap scan tree<Complex,2>")
     }
     CHECK(output == "2-1i 3-1i 5-1i 6-1i 7-1i 8-1i 13-1i ");
 }
+
+TEST_CASE("21. Test arena storage tree<int,2>")
+{
+    Tree<int,2> tree(NodeStorage::Arena);
+    CHECK(tree.storage() == NodeStorage::Arena);
+    createInt2Tree(tree);
+
+    std::string output;    
+    for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "8 13 6 7 5 3 2 ");
+
+    // The tree is reusable after its slabs were released
+    tree.clear();
+    CHECK(tree.getRoot() == nullptr);
+    createInt2Tree(tree);
+    CHECK(tree.getRoot()->get_children()[1]->get_value() == 5);
+
+    // Nodes kept by a caller keep their arena alive after the tree is gone
+    std::shared_ptr<Node<int,2>> kept;
+    {
+        Tree<int,2> scoped(NodeStorage::Arena);
+        createInt2Tree(scoped);
+        kept = scoped.getRoot();
+        scoped.clear();
+        createInt2Tree(scoped);
+    }
+    CHECK(kept->get_value() == 8);
+    CHECK(kept->get_children()[0]->get_children()[1]->get_value() == 7);
+
+    // A moved tree keeps allocating from an arena, and a detached node outlives its tree
+    std::shared_ptr<Node<int,2>> detached;
+    {
+        Tree<int,2> source(NodeStorage::Arena);
+        Tree<int,2> moved(std::move(source));
+        CHECK(moved.storage() == NodeStorage::Arena);
+        createInt2Tree(moved);
+        detached = moved.create_node(Node<int,2>(42));
+    }
+    CHECK(detached->get_value() == 42);
+}
+
+TEST_CASE("22. Test inline and vector child storage")
+{
+    // Small K keeps the child links inside the node, large K falls back to std::vector
+    CHECK(std::is_same<Node<int,2>::ChildList, ChildArray<std::shared_ptr<Node<int,2>>, 2>>::value);
+    CHECK(std::is_same<Node<int,16>::ChildList, std::vector<std::shared_ptr<Node<int,16>>>>::value);
+
+    Tree<int,16> tree;
+    Node<int,16> root = Node<int,16>(0);
+    tree.add_root(root);
+    for (int i = 1; i <= 20; i++) {
+        tree.add_sub_node(root, Node<int,16>(i));
+    }
+    CHECK(tree.getRoot()->get_children().size() == 16);
+
+    std::string output;    
+    for (auto node = tree.begin_post_order(); node != tree.end_post_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 0 ");
+
+    // A moved-from node is left without children, inline or not
+    Node<int,2> from(1);
+    from.add_child(std::make_shared<Node<int,2>>(2));
+    Node<int,2> to(std::move(from));
+    CHECK(from.get_children().empty());
+    CHECK(to.get_children().size() == 1);
+    Node<int,2> assigned(3);
+    assigned = std::move(to);
+    CHECK(to.get_children().empty());
+    CHECK(assigned.get_children()[0]->get_value() == 2);
+
+    Tree<int,2> moved;
+    moved.add_root(from);
+    output.clear();
+    for (auto node = moved.begin_pre_order(); node != moved.end_pre_order(); ++node) output += std::to_string(node.get_value());
+    CHECK(output == "1");
+}
+
+template<typename Iterator>
+std::string scanDoubles(Iterator node, Iterator end) {
+    std::string output;
+    for (; node != end; ++node)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << node.get_value();
+        output += oss.str();    
+        output += " ";        
+    }
+    return output;
+}
+
+TEST_CASE("23. Test FlatTree scans tree<double,3>")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+    FlatTree<double,3> flat(tree);
+    CHECK(flat.size() == 15);
+
+    CHECK(scanDoubles(flat.begin_pre_order(), flat.end_pre_order()) == scanDoubles(tree.begin_pre_order(), tree.end_pre_order()));
+    CHECK(scanDoubles(flat.begin_post_order(), flat.end_post_order()) == scanDoubles(tree.begin_post_order(), tree.end_post_order()));
+    CHECK(scanDoubles(flat.begin_in_order(), flat.end_in_order()) == scanDoubles(tree.begin_in_order(), tree.end_in_order()));
+    CHECK(scanDoubles(flat.begin_bfs_scan(), flat.end_bfs_scan()) == scanDoubles(tree.begin_bfs_scan(), tree.end_bfs_scan()));
+    CHECK(scanDoubles(flat.begin_dfs_scan(), flat.end_dfs_scan()) == scanDoubles(tree.begin_dfs_scan(), tree.end_dfs_scan()));
+
+    std::string output;
+    for (auto node = flat.myHeap(); node.isNotEmpty(); ++node)
+    {
+        output += std::to_string(static_cast<int>(node.get_value()));
+        output += " ";
+    }
+    CHECK(output == "1 2 3 5 8 13 21 34 55 89 144 233 269 377 400 ");
+}
+
+TEST_CASE("24. Test FlatTree round trip to Tree")
+{
+    Tree<int,2> tree;
+    createInt2Tree(tree);
+    Tree<int,2> copy = FlatTree<int,2>(tree).to_tree();
+
+    std::string output;    
+    for (auto node = copy.begin_post_order(); node != copy.end_post_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "6 7 13 3 2 5 8 ");
+
+    FlatTree<int,2> empty;
+    CHECK_FALSE(empty.begin_pre_order() != empty.end_pre_order());
+    CHECK(empty.to_tree().getRoot() == nullptr);
+}
+
+TEST_CASE("25. Test ImplicitTree scans tree<int,2>")
+{
+    // Same shape as createInt2Tree, stored level by level with no pointers
+    ImplicitTree<int,2> tree(std::vector<int>{8, 13, 5, 6, 7, 3, 2});
+    CHECK(ImplicitTree<int,2>::child(1, 1) == 4);
+    CHECK(ImplicitTree<int,2>::parent(6) == 2);
+
+    auto scan = [](auto node, auto end) {
+        std::string output;
+        for (; node != end; ++node)
+        {
+            output += std::to_string(node.get_value());
+            output += " ";
+        }
+        return output;
+    };
+    CHECK(scan(tree.begin_pre_order(), tree.end_pre_order()) == "8 13 6 7 5 3 2 ");
+    CHECK(scan(tree.begin_post_order(), tree.end_post_order()) == "6 7 13 3 2 5 8 ");
+    CHECK(scan(tree.begin_in_order(), tree.end_in_order()) == "6 13 7 8 3 5 2 ");
+    CHECK(scan(tree.begin_bfs_scan(), tree.end_bfs_scan()) == "8 13 5 6 7 3 2 ");
+    CHECK(scan(tree.begin_dfs_scan(), tree.end_dfs_scan()) == "8 13 6 7 5 3 2 ");
+
+    std::string output;
+    for (auto node = tree.myHeap(); node.isNotEmpty(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";
+    }
+    CHECK(output == "2 3 5 6 7 8 13 ");
+}
+
+TEST_CASE("26. Test ImplicitTree with a partial last level")
+{
+    ImplicitTree<int,3> tree;
+    for (int i = 0; i < 6; i++) {
+        tree.push_back(i);
+    }
+    // 0 has children 1 2 3, 1 has children 4 5
+    Tree<int,3> pointers = tree.to_tree();
+    CHECK(pointers.getRoot()->get_children().size() == 3);
+    CHECK(pointers.getRoot()->get_children()[0]->get_children().size() == 2);
+
+    std::string output;
+    for (auto node = tree.begin_post_order(); node != tree.end_post_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";
+    }
+    CHECK(output == "4 5 1 2 3 0 ");
+}
+
+TEST_CASE("27. Test handle based add_sub_node with duplicate values")
+{
+    // Value based inserts would always find the first (1); handles address each node directly
+    Tree<int,2> tree;
+    auto root = tree.add_root(Node<int,2>(1));
+    auto left = tree.add_sub_node(root, Node<int,2>(1));
+    auto right = tree.add_sub_node(root, Node<int,2>(1));
+    tree.add_sub_node(left, Node<int,2>(2));
+    tree.add_sub_node(right, Node<int,2>(3));
+    tree.add_sub_node(right, Node<int,2>(4));
+    CHECK_FALSE(tree.add_sub_node(root, Node<int,2>(5)));
+    CHECK(left->get_value() == 1);
+
+    std::string output;    
+    for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "1 1 2 1 3 4 ");
+
+    // The value based overload still works and returns a handle too
+    Node<int,2> two = Node<int,2>(2);
+    auto leaf = tree.add_sub_node(two, Node<int,2>(9));
+    CHECK(leaf);
+    CHECK(tree.getRoot()->get_children()[0]->get_children()[0]->get_children()[0]->get_value() == 9);
+}
+
+// A value type without std::hash, to check the tree still works without an index
+struct Unhashable {
+    int id;
+    bool operator==(const Unhashable& other) const { return id == other.id; }
+};
+
+TEST_CASE("28. Test value index tree<Complex,2>")
+{
+    Tree<Complex,2> tree;
+    tree.enable_index();
+    createComplex2Tree(tree);
+    CHECK(tree.has_index());
+    CHECK(tree.find(Complex(3,-1))->get_value().toString() == "3-1i");
+    CHECK_FALSE(tree.find(Complex(4,-1)));
+
+    std::string output;    
+    for (auto node = tree.begin_bfs_scan(); node != tree.end_bfs_scan(); ++node)
+    {
+        output += node.get_value().toString();
+        output += " ";        
+    }
+    CHECK(output == "8-1i 13-1i 5-1i 6-1i 7-1i 3-1i 2-1i "); 
+
+    // Duplicate values are first-wins, and clear() empties the index
+    Node<Complex,2> five = Node<Complex,2>(Complex(5,-1));
+    auto first_five = tree.find(Complex(5,-1));
+    tree.add_sub_node(tree.find(Complex(6,-1)), five);
+    CHECK((tree.find(Complex(5,-1)) == first_five));
+    tree.clear();
+    CHECK_FALSE(tree.find(Complex(8,-1)));
+}
+
+TEST_CASE("29. Test value based insert without std::hash")
+{
+    CHECK_FALSE(is_hashable<Unhashable>::value);
+    Tree<Unhashable,2> tree;
+    Node<Unhashable,2> root = Node<Unhashable,2>(Unhashable{1});
+    tree.add_root(root);
+    tree.add_sub_node(root, Node<Unhashable,2>(Unhashable{2}));
+    CHECK(tree.find(Unhashable{2})->get_value().id == 2);
+}
+
+TEST_CASE("30. Test bulk build from parents and edges")
+{
+    const size_t ROOT = Tree<double,3>::NO_PARENT;
+    Tree<double,3> tree;
+    tree.build_from_parents({1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377, 400, 269},
+                            {ROOT, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 7, 7});
+    Tree<double,3> expected;
+    createDouble3Tree(expected);
+    CHECK(scanDoubles(tree.begin_pre_order(), tree.end_pre_order()) == scanDoubles(expected.begin_pre_order(), expected.end_pre_order()));
+    CHECK(scanDoubles(tree.begin_in_order(), tree.end_in_order()) == scanDoubles(expected.begin_in_order(), expected.end_in_order()));
+
+    Tree<int,2> edges;
+    edges.build_from_edges({8, 13, 5, 6, 7, 3, 2}, {{0, 1}, {0, 2}, {1, 3}, {1, 4}, {2, 5}, {2, 6}});
+    std::string output;    
+    for (auto node = edges.begin_post_order(); node != edges.end_post_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "6 7 13 3 2 5 8 ");
+
+    // The same tree with children listed before their parents
+    const size_t NONE = Tree<int,2>::NO_PARENT;
+    Tree<int,2> unordered;
+    unordered.build_from_parents({6, 3, 8, 13, 5, 7, 2}, {3, 4, NONE, 2, 2, 3, 4});
+    output.clear();
+    for (auto node = unordered.begin_post_order(); node != unordered.end_post_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "6 7 13 3 2 5 8 ");
+}
+
+TEST_CASE("31. Test bulk build validation")
+{
+    const size_t ROOT = Tree<int,2>::NO_PARENT;
+    Tree<int,2> tree;
+    CHECK_THROWS_AS(tree.build_from_parents({1, 2, 3, 4}, {ROOT, 0, 0, 0}), std::invalid_argument);
+    CHECK_THROWS_AS(tree.build_from_parents({1, 2}, {ROOT, ROOT}), std::invalid_argument);
+    CHECK_THROWS_AS(tree.build_from_parents({1, 2, 3}, {ROOT, 2, 1}), std::invalid_argument);
+    CHECK_THROWS_AS(tree.build_from_parents({1, 2}, {ROOT, 5}), std::invalid_argument);
+    CHECK_THROWS_AS(tree.build_from_edges({1, 2, 3}, {{0, 2}, {1, 2}}), std::invalid_argument);
+    CHECK(tree.getRoot() == nullptr);
+}
+
+// Value type that counts how often it is copied
+struct CopyCounter {
+    static int copies;
+    std::string payload;
+    CopyCounter(const std::string& text, int repeat) : payload(repeat, text[0]) {}
+    CopyCounter(const CopyCounter& other) : payload(other.payload) { copies++; }
+    CopyCounter(CopyCounter&& other) noexcept : payload(std::move(other.payload)) {}
+    CopyCounter& operator=(const CopyCounter& other) { payload = other.payload; copies++; return *this; }
+    CopyCounter& operator=(CopyCounter&& other) noexcept { payload = std::move(other.payload); return *this; }
+    bool operator==(const CopyCounter& other) const { return payload == other.payload; }
+    bool operator>(const CopyCounter& other) const { return payload > other.payload; }
+};
+int CopyCounter::copies = 0;
+
+TEST_CASE("32. Test emplace and move insertion without copies")
+{
+    CopyCounter::copies = 0;
+    Tree<CopyCounter,2> tree;
+    auto root = tree.emplace_root("a", 3);
+    auto left = tree.emplace_child(root, "b", 1000);
+    tree.add_sub_node(root, Node<CopyCounter,2>(CopyCounter("c", 2)));
+    tree.add_sub_node(left, Node<CopyCounter,2>(std::in_place, "d", 4));
+    CHECK(CopyCounter::copies == 0);
+
+    std::string output;    
+    for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node)
+    {
+        output += node.get_value().payload.substr(0, 4);
+        output += " ";        
+    }
+    CHECK(output == "aaa bbbb dddd cc ");
+}
+
+TEST_CASE("33. Test traversals return values by const reference")
+{
+    Tree<CopyCounter,2> tree;
+    auto root = tree.emplace_root("r", 8);
+    tree.emplace_child(tree.emplace_child(root, "x", 8), "y", 8);
+    tree.emplace_child(root, "z", 8);
+
+    CopyCounter::copies = 0;
+    size_t total = 0;
+    for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node) total += (*node).payload.size();
+    for (auto node = tree.begin_post_order(); node != tree.end_post_order(); ++node) total += node.get_value().payload.size();
+    for (auto node = tree.begin_in_order(); node != tree.end_in_order(); ++node) total += (*node).payload.size();
+    for (auto node = tree.begin_bfs_scan(); node != tree.end_bfs_scan(); ++node) total += (*node).payload.size();
+    for (auto node = tree.begin_dfs_scan(); node != tree.end_dfs_scan(); ++node) total += node.get_value().payload.size();
+    CHECK(total == 5 * 4 * 8);
+    CHECK(CopyCounter::copies == 0);
+    CHECK(&tree.getRoot()->get_value() == &*tree.begin_pre_order());
+}
+
+TEST_CASE("34. Test iterative teardown of a deep chain")
+{
+    // A chain this deep overflows the stack if every level is destroyed recursively
+    const int DEPTH = 1000000;
+    for (auto storage : {NodeStorage::Shared, NodeStorage::Arena}) {
+        Tree<int,2> tree(storage);
+        auto node = tree.add_root(Node<int,2>(0));
+        for (int i = 1; i < DEPTH; i++) {
+            node = tree.add_sub_node(node, Node<int,2>(i));
+        }
+        CHECK(node->get_value() == DEPTH - 1);
+        tree.clear();
+        CHECK(tree.getRoot() == nullptr);
+    }
+
+    // Replacing the root of a deep chain tears the old chain down the same way
+    Tree<int,2> chain;
+    std::vector<size_t> parents(DEPTH);
+    parents[0] = Tree<int,2>::NO_PARENT;
+    std::iota(parents.begin() + 1, parents.end(), 0);
+    chain.build_from_parents(std::vector<int>(DEPTH, 1), parents);
+    chain.add_root(Node<int,2>(7));
+    CHECK(chain.getRoot()->get_value() == 7);
+    CHECK(chain.getRoot()->get_children().empty());
+
+    // A subtree still shared with another tree survives the teardown
+    Tree<int,2> tree;
+    createInt2Tree(tree);
+    {
+        Tree<int,2> subtree;
+        subtree.add_root(*tree.getRoot()->get_children()[0]);
+    }
+    std::string output;    
+    for (auto node = tree.begin_pre_order(); node != tree.end_pre_order(); ++node)
+    {
+        output += std::to_string(node.get_value());
+        output += " ";        
+    }
+    CHECK(output == "8 13 6 7 5 3 2 ");
+}
+
+TEST_CASE("35. Test pre order and in order scans hold no node references")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+    auto& children = tree.getRoot()->get_children();
+
+    auto pre = tree.begin_pre_order();
+    ++pre;
+    ++pre;
+    auto in = tree.begin_in_order();
+    ++in;
+    // A copying iterator would hold extra shared_ptr references to the pending children
+    CHECK(children[1].use_count() == 1);
+    CHECK(children[2].use_count() == 1);
+    CHECK(*pre == 8.0);
+    CHECK(*in == 2.0);
+}
+
+// Reference post-order scan written recursively
+template<typename T, size_t K>
+void postOrderReference(const Node<T,K>* node, std::vector<T>& out) {
+    for (const auto& child : node->get_children()) {
+        postOrderReference(child.get(), out);
+    }
+    out.push_back(node->get_value());
+}
+
+template<typename T, size_t K>
+bool postOrderMatchesReference(Tree<T,K>& tree) {
+    std::vector<T> expected, actual;
+    postOrderReference<T,K>(tree.getRoot().get(), expected);
+    for (auto node = tree.begin_post_order(); node != tree.end_post_order(); ++node) {
+        actual.push_back(*node);
+    }
+    return actual == expected;
+}
+
+TEST_CASE("36. Test post order scan order is unchanged")
+{
+    Tree<int,2> int2;
+    createInt2Tree(int2);
+    CHECK(postOrderMatchesReference(int2));
+
+    Tree<double,3> double3;
+    createDouble3Tree(double3);
+    CHECK(postOrderMatchesReference(double3));
+
+    Tree<Complex,2> complex2;
+    createComplex2Tree(complex2);
+    CHECK(postOrderMatchesReference(complex2));
+
+    // Wide tree: two full levels of 64 children
+    Tree<int,64> wide;
+    auto root = wide.add_root(Node<int,64>(0));
+    for (int i = 1; i <= 64; i++) {
+        auto child = wide.add_sub_node(root, Node<int,64>(i));
+        for (int j = 0; j < 64; j++) {
+            wide.add_sub_node(child, Node<int,64>(i * 100 + j));
+        }
+    }
+    CHECK(postOrderMatchesReference(wide));
+}
+
+TEST_CASE("37. Test traversals past the inline buffers and with scratch")
+{
+    // 300 nodes in a complete 4-ary tree: BFS queues and pre-order stacks outgrow 32 inline entries
+    Tree<int,4> tree;
+    std::vector<NodeHandle<int,4>> handles;
+    handles.push_back(tree.add_root(Node<int,4>(0)));
+    for (int i = 1; i < 300; i++) {
+        handles.push_back(tree.add_sub_node(handles[(i - 1) / 4], Node<int,4>(i)));
+    }
+    auto scan = [](auto node, auto end) {
+        std::vector<int> output;
+        for (; node != end; ++node) output.push_back(*node);
+        return output;
+    };
+
+    std::vector<int> bfs = scan(tree.begin_bfs_scan(), tree.end_bfs_scan());
+    CHECK(bfs.size() == 300);
+    CHECK(std::is_sorted(bfs.begin(), bfs.end()));
+
+    TraversalScratch<int,4> scratch;
+    CHECK(scan(tree.begin_bfs_scan(scratch), tree.end_bfs_scan()) == bfs);
+    auto* reused = scratch.nodes.data();
+    CHECK(scan(tree.begin_bfs_scan(scratch), tree.end_bfs_scan()) == bfs);
+    CHECK(scratch.nodes.data() == reused);
+
+    CHECK(scan(tree.begin_pre_order(scratch), tree.end_pre_order()) == scan(tree.begin_pre_order(), tree.end_pre_order()));
+    CHECK(scan(tree.begin_in_order(scratch), tree.end_in_order()) == scan(tree.begin_in_order(), tree.end_in_order()));
+    CHECK(postOrderMatchesReference(tree));
+    CHECK(scan(tree.begin_post_order(scratch), tree.end_post_order()) == scan(tree.begin_post_order(), tree.end_post_order()));
+
+    // A copied iterator continues independently of the original
+    auto it = tree.begin_bfs_scan(scratch);
+    for (int i = 0; i < 100; i++) ++it;
+    auto copy = it;
+    ++it;
+    CHECK(*copy == 100);
+    CHECK(*it == 101);
+
+    // A chain deeper than the inline stack
+    Tree<int,2> chain;
+    auto node = chain.add_root(Node<int,2>(0));
+    for (int i = 1; i < 100; i++) {
+        node = chain.add_sub_node(node, Node<int,2>(i));
+    }
+    CHECK(scan(chain.begin_post_order(), chain.end_post_order()).front() == 99);
+    CHECK(scan(chain.begin_in_order(), chain.end_in_order()).back() == 0);
+}
+
+TEST_CASE("38. Test level by level BFS tree<double,3>")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+
+    std::string output;
+    std::vector<size_t> sizes;
+    for (auto level = tree.begin_levels(); level != tree.end_levels(); ++level)
+    {
+        CHECK(level.depth() == sizes.size());
+        sizes.push_back(level.size());
+        for (auto node = level.begin_level(); node != level.end_level(); ++node)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1) << (*node)->get_value();
+            output += oss.str();
+            output += " ";
+        }
+        output += "| ";
+    }
+    CHECK(sizes == std::vector<size_t>{1, 3, 9, 2});
+    CHECK(output == "1.0 | 2.0 3.0 5.0 | 8.0 13.0 21.0 34.0 55.0 89.0 144.0 233.0 377.0 | 400.0 269.0 | ");
+
+    Tree<double,3> empty;
+    CHECK_FALSE(empty.begin_levels() != empty.end_levels());
+}
+
+TEST_CASE("39. Test for_each traversals with early exit")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+
+    std::vector<double> pre, post, bfs;
+    CHECK(tree.for_each_pre_order([&](const double& value) { pre.push_back(value); }));
+    CHECK(tree.for_each_post_order([&](const double& value) { post.push_back(value); }));
+    CHECK(tree.for_each_bfs([&](const double& value) { bfs.push_back(value); }));
+
+    auto collect = [](auto node, auto end) {
+        std::vector<double> output;
+        for (; node != end; ++node) output.push_back(*node);
+        return output;
+    };
+    CHECK(pre == collect(tree.begin_pre_order(), tree.end_pre_order()));
+    CHECK(post == collect(tree.begin_post_order(), tree.end_post_order()));
+    CHECK(bfs == collect(tree.begin_bfs_scan(), tree.end_bfs_scan()));
+
+    // Returning false stops the scan right after the matching node
+    std::vector<double> visited;
+    bool completed = tree.for_each_pre_order([&](double value) {
+        visited.push_back(value);
+        return value != 34;
+    });
+    CHECK_FALSE(completed);
+    CHECK(visited == std::vector<double>{1, 2, 8, 13, 21, 3, 34});
+
+    Tree<double,3> empty;
+    CHECK(empty.for_each_bfs([](double) { return false; }));
+}
+
+TEST_CASE("40. Test pruning subtrees during traversal")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+
+    // Iterators: skip the subtrees below 2 and 3
+    auto prune = [](auto node, auto end) {
+        std::vector<double> output;
+        while (node != end) {
+            output.push_back(*node);
+            if (*node == 2 || *node == 3) {
+                node.skip_children();
+            } else {
+                ++node;
+            }
+        }
+        return output;
+    };
+    CHECK(prune(tree.begin_pre_order(), tree.end_pre_order()) == std::vector<double>{1, 2, 3, 5, 144, 233, 377});
+    CHECK(prune(tree.begin_dfs_scan(), tree.end_dfs_scan()) == std::vector<double>{1, 2, 3, 5, 144, 233, 377});
+    CHECK(prune(tree.begin_bfs_scan(), tree.end_bfs_scan()) == std::vector<double>{1, 2, 3, 5, 144, 233, 377});
+
+    // Callbacks: skip the subtree below 3, stop at 233
+    std::vector<double> pre;
+    bool completed = tree.for_each_pre_order([&](double value) {
+        pre.push_back(value);
+        if (value == 3) return VisitResult::SkipChildren;
+        if (value == 233) return VisitResult::Stop;
+        return VisitResult::Continue;
+    });
+    CHECK_FALSE(completed);
+    CHECK(pre == std::vector<double>{1, 2, 8, 13, 21, 3, 5, 144, 233});
+
+    std::vector<double> bfs;
+    CHECK(tree.for_each_bfs([&](double value) {
+        bfs.push_back(value);
+        return (value == 3) ? VisitResult::SkipChildren : VisitResult::Continue;
+    }));
+    CHECK(bfs == std::vector<double>{1, 2, 3, 5, 8, 13, 21, 144, 233, 377});
+
+    // Post-order has already visited the children, so nothing is pruned
+    size_t count = 0;
+    CHECK(tree.for_each_post_order([&](double) { ++count; return VisitResult::SkipChildren; }));
+    CHECK(count == 15);
+}
+
+TEST_CASE("41. Test stackless traversals over parent links")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+
+    auto collect = [](auto node, auto end) {
+        std::vector<double> output;
+        for (; node != end; ++node) output.push_back(*node);
+        return output;
+    };
+    CHECK(collect(tree.begin_stackless_pre_order(), tree.end_stackless_pre_order()) == collect(tree.begin_pre_order(), tree.end_pre_order()));
+    CHECK(collect(tree.begin_stackless_post_order(), tree.end_stackless_post_order()) == collect(tree.begin_post_order(), tree.end_post_order()));
+    CHECK(collect(tree.begin_stackless_in_order(), tree.end_stackless_in_order()) == collect(tree.begin_in_order(), tree.end_in_order()));
+
+    // Parent links and child indexes are kept by add_child
+    auto root = tree.getRoot();
+    auto child = root->get_children()[1];
+    CHECK(root->get_parent() == nullptr);
+    CHECK(child->get_parent() == root.get());
+    CHECK(child->get_child_index() == 1);
+
+    // A shallow copy of an inner node as root walks only its own subtree
+    Tree<double,3> copy;
+    copy.add_root(*child);
+    CHECK(collect(copy.begin_stackless_pre_order(), copy.end_stackless_pre_order()) == std::vector<double>{3, 34, 400, 269, 55, 89});
+    CHECK(collect(copy.begin_stackless_post_order(), copy.end_stackless_post_order()) == std::vector<double>{400, 269, 34, 55, 89, 3});
+    CHECK(collect(copy.begin_stackless_in_order(), copy.end_stackless_in_order()) == collect(copy.begin_in_order(), copy.end_in_order()));
+
+    // Deep chain and wide node, with every iterator the size of two pointers
+    Tree<int,4> mixed;
+    auto node = mixed.add_root(Node<int,4>(0));
+    for (int i = 1; i < 200; ++i) {
+        node = mixed.add_sub_node(node, Node<int,4>(i));
+    }
+    for (int i = 200; i < 204; ++i) {
+        mixed.add_sub_node(node, Node<int,4>(i));
+    }
+    auto collectInts = [](auto it, auto end) {
+        std::vector<int> output;
+        for (; it != end; ++it) output.push_back(*it);
+        return output;
+    };
+    CHECK(collectInts(mixed.begin_stackless_pre_order(), mixed.end_stackless_pre_order()) == collectInts(mixed.begin_pre_order(), mixed.end_pre_order()));
+    CHECK(collectInts(mixed.begin_stackless_post_order(), mixed.end_stackless_post_order()) == collectInts(mixed.begin_post_order(), mixed.end_post_order()));
+    CHECK(collectInts(mixed.begin_stackless_in_order(), mixed.end_stackless_in_order()) == collectInts(mixed.begin_in_order(), mixed.end_in_order()));
+    CHECK(sizeof(StacklessPreOrderIterator<int,4>) == 2 * sizeof(void*));
+
+    // A non-root copy of a node with children gets its own subtree, linked to the copy
+    Tree<int,2> copied;
+    auto top = copied.add_root(Node<int,2>(1));
+    {
+        Node<int,2> sub(2);
+        sub.add_child(std::make_shared<Node<int,2>>(3));
+        sub.get_children()[0]->add_child(std::make_shared<Node<int,2>>(4));
+        copied.add_sub_node(top, sub);
+        copied.getRoot()->add_child(copied.create_node(sub));
+    }
+    CHECK(copied.getRoot()->get_children()[0]->get_children()[0]->get_parent() == copied.getRoot()->get_children()[0].get());
+    CHECK(collectInts(copied.begin_stackless_pre_order(), copied.end_stackless_pre_order()) == std::vector<int>{1, 2, 3, 4, 2, 3, 4});
+    CHECK(collectInts(copied.begin_stackless_post_order(), copied.end_stackless_post_order()) == std::vector<int>{4, 3, 2, 4, 3, 2, 1});
+    CHECK(collectInts(copied.begin_stackless_in_order(), copied.end_stackless_in_order()) == collectInts(copied.begin_in_order(), copied.end_in_order()));
+
+    // A root copied from a node with children gets its own subtree as well
+    Tree<int,2> rooted;
+    {
+        Node<int,2> sub(2);
+        sub.add_child(std::make_shared<Node<int,2>>(3));
+        rooted.add_root(sub);
+    }
+    CHECK(rooted.getRoot()->get_children()[0]->get_parent() == rooted.getRoot().get());
+    CHECK(collectInts(rooted.begin_stackless_post_order(), rooted.end_stackless_post_order()) == std::vector<int>{3, 2});
+
+    Tree<int,4> empty;
+    CHECK_FALSE(empty.begin_stackless_post_order() != empty.end_stackless_post_order());
+    CHECK_FALSE(empty.begin_stackless_in_order() != empty.end_stackless_in_order());
+}
+
+static_assert(std::forward_iterator<PreOrderIterator<double,3>>);
+static_assert(std::forward_iterator<PostOrderIterator<double,3>>);
+static_assert(std::forward_iterator<InOrderIterator<double,3>>);
+static_assert(std::forward_iterator<BFSIterator<double,3>>);
+static_assert(std::forward_iterator<DFSIterator<double,3>>);
+static_assert(std::forward_iterator<HeapIterator<double,3>>);
+static_assert(std::forward_iterator<StacklessInOrderIterator<double,3>>);
+static_assert(std::forward_iterator<IndexPostOrderIterator<FlatTree<double,3>>>);
+static_assert(std::forward_iterator<IndexBFSIterator<ImplicitTree<double,3>>>);
+static_assert(std::ranges::forward_range<TraversalRange<PreOrderIterator<double,3>>>);
+
+TEST_CASE("42. Test traversals as standard iterators and ranges")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+
+    // Standard algorithms over begin/end pairs
+    double sum = std::accumulate(tree.begin_bfs_scan(), tree.end_bfs_scan(), 0.0);
+    CHECK(sum == 1654);
+    CHECK(*std::max_element(tree.begin_post_order(), tree.end_post_order()) == 400);
+    CHECK(std::distance(tree.begin_in_order(), tree.end_in_order()) == 15);
+
+    // Range-for and lazy views, with no intermediate vector
+    std::vector<double> pre;
+    for (const double& value : tree.pre_order()) pre.push_back(value);
+    CHECK(pre == std::vector<double>{1, 2, 8, 13, 21, 3, 34, 400, 269, 55, 89, 5, 144, 233, 377});
+
+    std::vector<double> large;
+    for (double value : tree.dfs() | std::views::filter([](double v) { return v > 100; })
+                                   | std::views::transform([](double v) { return v / 2; })) {
+        large.push_back(value);
+    }
+    CHECK(large == std::vector<double>{200, 134.5, 72, 116.5, 188.5});
+
+    std::vector<double> sorted;
+    for (double value : tree.heap() | std::views::take(4)) sorted.push_back(value);
+    CHECK(sorted == std::vector<double>{1, 2, 3, 5});
+
+    // Equality is by position: a copy advanced the same way meets the original
+    auto first = tree.begin_bfs_scan();
+    auto second = first;
+    CHECK(first == second);
+    CHECK(*first++ == 1);
+    CHECK(first != second);
+    ++second;
+    CHECK(first == second);
+    CHECK(*first == 2);
+
+    Tree<std::string,2> words;
+    words.emplace_root("tree");
+    CHECK(words.begin_pre_order()->size() == 4);
+
+    // Array based trees expose the same ranges
+    FlatTree<double,3> flat(tree);
+    CHECK(std::ranges::equal(flat.post_order(), tree.post_order()));
+    CHECK(std::ranges::equal(flat.in_order(), tree.in_order()));
+    CHECK(std::ranges::distance(flat.bfs()) == 15);
+
+    Tree<double,3> empty;
+    CHECK(empty.pre_order().begin() == std::default_sentinel);
+    CHECK(std::ranges::distance(empty.heap()) == 0);
+}
+
+TEST_CASE("43. Test heap comparators and top_k")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+    std::vector<double> ascending{1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 269, 377, 400};
+
+    std::vector<double> sorted;
+    for (const double& value : tree.heap()) sorted.push_back(value);
+    CHECK(sorted == ascending);
+
+    std::vector<double> descending;
+    for (HeapIterator<double,3,std::less<double>> it(tree.getRoot()); it != std::default_sentinel; ++it) descending.push_back(*it);
+    CHECK(descending == std::vector<double>(ascending.rbegin(), ascending.rend()));
+
+    // The frontier scan of a tree heap-ordered under the comparator points into the tree, so values are never copied
+    CopyCounter::copies = 0;
+    Tree<CopyCounter,2> strings;
+    auto root = strings.emplace_root("a", 5);
+    strings.emplace_child(root, "c", 5);
+    strings.emplace_child(root, "b", 5);
+    auto byPayload = [](const CopyCounter& a, const CopyCounter& b) { return a.payload > b.payload; };
+    std::string order;
+    HeapIterator<CopyCounter,2,decltype(byPayload)> it(strings.getRoot(), frontier_scan, byPayload);
+    for (; it != std::default_sentinel; ++it) order += it->payload[0];
+    CHECK(order == "abc");
+    CHECK(CopyCounter::copies == 0);
+
+    // top_k keeps the first k values of the same order
+    CHECK(tree.top_k(4) == std::vector<double>{1, 2, 3, 5});
+    CHECK(tree.top_k(3, std::less<double>()) == std::vector<double>{400, 377, 269});
+    CHECK(tree.top_k(100) == ascending);
+    CHECK(tree.top_k(0).empty());
+    CHECK(FlatTree<double,3>(tree).top_k(2) == std::vector<double>{1, 2});
+
+    // The comparator also applies to the copying HeapIterator
+    HeapIterator<double,3,std::less<double>> largest(tree.getRoot());
+    CHECK(*largest == 400);
+    CHECK(*++largest == 377);
+}
+
+TEST_CASE("44. Test heap-ordered trees scan their frontier")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+    std::vector<double> ascending{1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 269, 377, 400};
+
+    // Every parent is at most its children, including 34 above 400 and 269
+    CHECK(tree.is_heap_ordered());
+    std::vector<double> sorted;
+    for (auto node = tree.myHeap(); node.isNotEmpty(); ++node) sorted.push_back(*node);
+    CHECK(sorted == ascending);
+
+    // A smaller child breaks the order
+    auto eight = tree.find(8);
+    tree.add_sub_node(eight, Node<double,3>(0.5));
+    CHECK_FALSE(tree.is_heap_ordered());
+    sorted.clear();
+    for (double value : tree.heap()) sorted.push_back(value);
+    ascending.insert(ascending.begin(), 0.5);
+    CHECK(sorted == ascending);
+
+    // The frontier scan yields values straight from the nodes, without copying them
+    CopyCounter::copies = 0;
+    Tree<CopyCounter,2> strings;
+    auto root = strings.emplace_root("a", 5);
+    auto left = strings.emplace_child(root, "c", 5);
+    strings.emplace_child(root, "b", 5);
+    strings.emplace_child(left, "d", 5);
+    CHECK(strings.is_heap_ordered());
+    std::string order;
+    for (auto node = strings.myHeap(); node.isNotEmpty(); ++node) order += node->payload[0];
+    CHECK(order == "abcd");
+    CHECK(CopyCounter::copies == 0);
+
+    // Copies advanced the same number of steps are equal
+    auto first = strings.myHeap();
+    auto second = first;
+    ++first;
+    CHECK(first != second);
+    ++second;
+    CHECK(first == second);
+
+    // Changes made through the nodes themselves are seen as well
+    Tree<int,2> ints;
+    createInt2Tree(ints);
+    ints.getRoot()->get_children()[0]->get_children()[0]->add_child(std::make_shared<Node<int,2>>(1));
+    sorted.clear();
+    for (auto node = ints.myHeap(); node.isNotEmpty(); ++node) sorted.push_back(*node);
+    CHECK(sorted == std::vector<double>{1, 2, 3, 5, 6, 7, 8, 13});
+
+    // Trees move but do not copy, and a moved tree keeps scanning correctly
+    static_assert(!std::is_copy_constructible_v<Tree<int,2>> && !std::is_copy_assignable_v<Tree<int,2>>);
+    Tree<double,3> moved(std::move(tree));
+    moved.add_sub_node(moved.find(400), Node<double,3>(0.25));
+    tree = std::move(moved);
+    sorted.clear();
+    for (double value : tree.heap()) sorted.push_back(value);
+    ascending.insert(ascending.begin(), 0.25);
+    CHECK(sorted == ascending);
+
+    Tree<double,3> empty;
+    CHECK(empty.is_heap_ordered());
+    CHECK_FALSE(empty.myHeap().isNotEmpty());
+}
+
+TEST_CASE("45. Test parallel sorted scan merges sorted runs")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+    std::vector<double> ascending{1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 269, 377, 400};
+
+    for (size_t threads : {1, 2, 4, 16}) {
+        std::vector<double> sorted;
+        for (double value : tree.parallel_heap(threads)) sorted.push_back(value);
+        CHECK(sorted == ascending);
+    }
+
+    std::vector<double> descending;
+    for (auto it = tree.begin_parallel_heap(3, std::less<double>()); it.isNotEmpty(); ++it) descending.push_back(*it);
+    CHECK(descending == std::vector<double>(ascending.rbegin(), ascending.rend()));
+
+    // A larger tree with duplicates, split into many subtrees
+    Tree<int,4> big;
+    std::vector<NodeHandle<int,4>> handles{big.add_root(Node<int,4>(7))};
+    std::vector<int> expected{7};
+    for (int i = 1; i < 5000; ++i) {
+        int value = (i * 7919) % 1000;
+        handles.push_back(big.add_sub_node(handles[(i - 1) / 4], Node<int,4>(value)));
+        expected.push_back(value);
+    }
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> merged(big.begin_parallel_heap(4), MergeHeapIterator<int>());
+    CHECK(merged == expected);
+
+    // Copies share the runs and advance independently
+    auto first = big.begin_parallel_heap(2);
+    auto second = first;
+    ++first;
+    CHECK(*second == expected[0]);
+    CHECK(*first == expected[1]);
+
+    // A chain splits off only a bounded top run
+    const size_t LENGTH = 10000;
+    std::vector<size_t> parents(LENGTH);
+    std::vector<int> values(LENGTH);
+    for (size_t i = 0; i < LENGTH; ++i) {
+        parents[i] = (i == 0) ? Tree<int,2>::NO_PARENT : i - 1;
+        values[i] = static_cast<int>(LENGTH - i);
+    }
+    Tree<int,2> chain;
+    chain.build_from_parents(values, parents);
+    auto runs = sorted_runs(chain.getRoot().get(), 4, std::greater<int>());
+    CHECK(runs.size() == 2);
+    CHECK(runs.back().size() == MAX_SPLIT_LEVELS);
+    std::vector<int> chained(chain.begin_parallel_heap(4), MergeHeapIterator<int>());
+    CHECK(chained.size() == LENGTH);
+    CHECK(std::is_sorted(chained.begin(), chained.end()));
+
+    // An exception from the comparator on any thread reaches the caller
+    auto throwing = [](int a, int b) {
+        if (a == 500 || b == 500) throw std::runtime_error("compared 500");
+        return a > b;
+    };
+    CHECK_THROWS_AS(big.begin_parallel_heap(4, throwing), std::runtime_error);
+
+    Tree<int,4> empty;
+    CHECK_FALSE(empty.begin_parallel_heap(4).isNotEmpty());
+}
+
+TEST_CASE("46. Test radix sorted scan for numbers")
+{
+    // Past RADIX_SORT_MIN, so the byte passes run
+    std::vector<int> ints;
+    std::vector<double> doubles;
+    std::vector<int64_t> wide;
+    std::vector<unsigned char> bytes;
+    for (int i = 0; i < 1000; ++i) {
+        ints.push_back((i * 7919) % 2001 - 1000);
+        doubles.push_back(((i * 7919) % 2001 - 1000) / 7.0);
+        wide.push_back((i % 2 ? -1 : 1) * (int64_t(i) << 40));
+        bytes.push_back(static_cast<unsigned char>(i * 31));
+    }
+    doubles.push_back(-0.0);
+    doubles.push_back(std::numeric_limits<double>::infinity());
+    doubles.push_back(-std::numeric_limits<double>::infinity());
+    wide.push_back(std::numeric_limits<int64_t>::min());
+    wide.push_back(std::numeric_limits<int64_t>::max());
+
+    auto matchesSort = [](auto values) {
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        radix_sort(values);
+        return values == expected;
+    };
+    CHECK(matchesSort(ints));
+    CHECK(matchesSort(doubles));
+    CHECK(matchesSort(wide));
+    CHECK(matchesSort(bytes));
+    CHECK(matchesSort(std::vector<float>{3.5f, -1.25f, 0.0f, -7.0f, 2.0f}));
+
+    // HeapIterator keeps its interface on the radix path, in both directions
+    Tree<double,3> tree;
+    auto root = tree.add_root(Node<double,3>(doubles[0]));
+    std::vector<NodeHandle<double,3>> handles{root};
+    for (size_t i = 1; i < doubles.size(); ++i) {
+        handles.push_back(tree.add_sub_node(handles[(i - 1) / 3], Node<double,3>(doubles[i])));
+    }
+    std::vector<double> ascending;
+    for (auto node = tree.myHeap(); node.isNotEmpty(); ++node) ascending.push_back(node.get_value());
+    std::vector<double> expected = doubles;
+    std::sort(expected.begin(), expected.end());
+    CHECK(ascending == expected);
+
+    std::vector<double> descending;
+    for (auto node = HeapIterator<double,3,std::less<double>>(tree.getRoot()); node.isNotEmpty(); ++node) descending.push_back(*node);
+    CHECK(descending == std::vector<double>(expected.rbegin(), expected.rend()));
+}
+
+TEST_CASE("47. Test keyed sorted scan for Complex")
+{
+    Tree<Complex,2> tree;
+    createComplex2Tree(tree);
+    std::string keyed;
+    for (auto node = tree.myHeap(); node.isNotEmpty(); ++node) keyed += node.get_value().toString() + " ";
+    CHECK(keyed == "2-1i 3-1i 5-1i 6-1i 7-1i 8-1i 13-1i ");
+
+    // Same order as the comparison heap, which a transparent comparator still selects
+    Tree<Complex,2> big;
+    std::vector<NodeHandle<Complex,2>> handles{big.add_root(Node<Complex,2>(Complex(0, 0)))};
+    for (int i = 1; i < 500; ++i) {
+        Complex value((i * 37) % 101 - 50, (i * 53) % 89 - 44);
+        handles.push_back(big.add_sub_node(handles[(i - 1) / 2], Node<Complex,2>(value)));
+    }
+    std::vector<double> byKey, byHeap;
+    for (auto node = big.myHeap(); node.isNotEmpty(); ++node) byKey.push_back(node->sort_key());
+    for (HeapIterator<Complex,2,std::greater<>> node(big.getRoot()); node.isNotEmpty(); ++node) byHeap.push_back(node->sort_key());
+    CHECK(byKey == byHeap);
+    CHECK(std::is_sorted(byKey.begin(), byKey.end()));
+    CHECK(byKey.size() == 500);
+}
+
+static_assert(std::is_trivially_copyable_v<Complex>);
+static_assert((Complex(1, 2) * Complex(3, -1)).conjugate() == Complex(5, -5));
+static_assert((Complex(1, 2) + Complex(3, -1)).squared_magnitude() == 17);
+
+TEST_CASE("48. Test ComplexArray kernels match scalar Complex")
+{
+    // An odd size, so both the SIMD body and the scalar tail run
+    std::vector<Complex> a, b;
+    for (int i = 0; i < 37; ++i) {
+        a.emplace_back((i * 7) % 11 - 5.5, (i * 5) % 13 - 6.25);
+        b.emplace_back((i * 3) % 7 - 3.0, (i % 4 == 0) ? a.back().getImag() : (i * 11) % 9 - 4.5);
+    }
+    b[3] = a[3];
+    ComplexArray left(a), right(b);
+    CHECK(left.size() == 37);
+    CHECK((left[5] == a[5]));
+
+    auto squared = left.squared_magnitudes();
+    auto magnitudes = left.magnitudes();
+    auto sum = left + right;
+    auto product = left * right;
+    auto conjugate = left.conjugate();
+    auto greater = left.greater_than(right);
+    auto equal = left.equal_to(right);
+    bool all_match = true;
+    for (size_t i = 0; i < a.size(); ++i) {
+        all_match = all_match && squared[i] == a[i].squared_magnitude() && magnitudes[i] == a[i].sort_key()
+                    && sum[i] == a[i] + b[i] && product[i] == a[i] * b[i] && conjugate[i] == a[i].conjugate()
+                    && greater[i] == (a[i] > b[i]) && equal[i] == (a[i] == b[i]);
+    }
+    CHECK(all_match);
+    CHECK(equal[3] == 1);
+    CHECK(std::signbit(ComplexArray(std::vector<Complex>{Complex(1, 0)}).conjugate()[0].getImag()));
+
+    CHECK_THROWS_AS(left + ComplexArray(3), std::invalid_argument);
+    CHECK_THROWS_AS(left.greater_than(ComplexArray()), std::invalid_argument);
+    CHECK(ComplexArray().magnitudes().empty());
+}
+
+TEST_CASE("49. Test parallel for_each and reduce on a work-stealing pool")
+{
+    Tree<double,3> tree;
+    createDouble3Tree(tree);
+    WorkStealingPool single(1), several(4);
+    CHECK(single.size() == 1);
+    CHECK(several.size() == 4);
+    CHECK(parallel_reduce(tree, 0.0, std::plus<>(), single) == 1654);
+    CHECK(parallel_reduce(tree, 0.0, std::plus<>(), several) == 1654);
+
+    // Balanced and skewed trees large enough to be split into tasks
+    Tree<long,4> balanced;
+    std::vector<NodeHandle<long,4>> handles{balanced.add_root(Node<long,4>(0))};
+    for (long i = 1; i < 20000; ++i) {
+        handles.push_back(balanced.add_sub_node(handles[(i - 1) / 4], Node<long,4>(i)));
+    }
+    Tree<long,2> skewed;
+    NodeHandle<long,2> spine = skewed.add_root(Node<long,2>(0));
+    for (long i = 1; i < 20000; i += 2) {
+        skewed.add_sub_node(spine, Node<long,2>(i));
+        spine = skewed.add_sub_node(spine, Node<long,2>(i + 1));
+    }
+    for (WorkStealingPool* pool : {&single, &several}) {
+        CHECK(parallel_reduce(balanced, 0L, std::plus<>(), *pool) == 19999L * 20000 / 2);
+        CHECK(parallel_reduce(skewed, 0L, std::plus<>(), *pool) == 20000L * 20001 / 2);
+        std::atomic<long> count{0};
+        parallel_for_each(balanced, [&count](long) { ++count; }, *pool);
+        parallel_for_each(skewed, [&count](long) { ++count; }, *pool);
+        CHECK(count == 40001);
+    }
+    CHECK(parallel_reduce(balanced, 5L, [](long a, long b) { return std::max(a, b); }) == 19999);
+
+    // Errors reach the caller and the pool stays usable
+    CHECK_THROWS_AS(parallel_for_each(balanced, [](long value) {
+        if (value == 12345) throw std::runtime_error("stop");
+    }, several), std::runtime_error);
+    CHECK(parallel_reduce(balanced, 0L, std::plus<>(), several) == 19999L * 20000 / 2);
+
+    // Reductions to another type fold values and combine partials separately
+    auto count = [](size_t n, long) { return n + 1; };
+    for (WorkStealingPool* pool : {&single, &several}) {
+        CHECK(parallel_reduce(balanced, size_t(0), count, std::plus<>(), *pool) == 20000);
+        CHECK(parallel_reduce(skewed, size_t(0), count, std::plus<>(), *pool) == 20001);
+    }
+    Tree<Complex,2> complexTree;
+    createComplex2Tree(complexTree);
+    double magnitudes = 0;
+    complexTree.for_each_pre_order([&](const Complex& value) { magnitudes += value.sort_key(); });
+    auto addMagnitude = [](double sum, const Complex& value) { return sum + value.sort_key(); };
+    CHECK(parallel_reduce(complexTree, 0.0, addMagnitude, std::plus<>(), several) == doctest::Approx(magnitudes));
+
+    // A thread waiting with nothing to run counts as idle, so a running task sees wants_work()
+    // whichever thread runs it; the deadline only matters if that breaks
+    WorkStealingPool pair(2);
+    TaskGroup group;
+    bool sawIdle = false;
+    pair.spawn(group, [&] {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!pair.wants_work() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        sawIdle = pair.wants_work();
+    });
+    pair.wait(group);
+    CHECK(sawIdle);
+    std::atomic<long> visits{0};
+    parallel_for_each(balanced, [&visits](long) { ++visits; }, pair);
+    CHECK(visits == 20000);
+    CHECK(parallel_reduce(balanced, 0L, std::plus<>(), pair) == 19999L * 20000 / 2);
+
+    Tree<long,4> empty;
+    CHECK(parallel_reduce(empty, 42L, std::plus<>(), several) == 42);
+}
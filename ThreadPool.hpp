@@ -0,0 +1,188 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tasks spawned together and waited for together.
+// The first exception thrown by a task is kept and rethrown by WorkStealingPool::wait.
+class TaskGroup {
+private:
+    std::atomic<size_t> pending{0};
+    std::mutex error_lock;
+    std::exception_ptr error;
+
+    friend class WorkStealingPool;
+};
+
+// Work-stealing thread pool.
+// Each thread owns a deque: it pushes and pops its own tasks at the back (newest first), and idle
+// threads steal from the front of the others (oldest first, usually the largest pieces of work).
+// A pool of N threads starts N - 1 workers; the thread that calls wait() works as the N-th,
+// so a pool of 1 runs everything inline.
+class WorkStealingPool {
+private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;     // queue 0 belongs to threads outside the pool
+    std::vector<std::thread> workers;
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> idle{0};       // sleeping workers and waiting threads with nothing to run
+    std::atomic<bool> stopping{false};
+
+    // The pool and queue of the current thread, if it is a worker
+    static inline thread_local WorkStealingPool* current_pool = nullptr;
+    static inline thread_local size_t current_queue = 0;
+
+    size_t own_queue() const {
+        return (current_pool == this) ? current_queue : 0;
+    }
+
+    void push(Task task) {
+        Queue& queue = *queues[own_queue()];
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            queue.tasks.push_back(std::move(task));
+        }
+        ++queued;
+        if (idle > 0) {
+            // Taking the lock orders this wake-up after a sleeper's check of queued
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            wake.notify_one();
+        }
+    }
+
+    // Pop the newest own task, or steal the oldest task of another queue
+    bool take(Task& task) {
+        size_t own = own_queue();
+        for (size_t i = 0; i < queues.size(); ++i) {
+            Queue& queue = *queues[(own + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (!queue.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                --queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(size_t queue) {
+        current_pool = this;
+        current_queue = queue;
+        Task task;
+        while (!stopping) {
+            if (take(task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(sleep_lock);
+            ++idle;
+            wake.wait(guard, [this] { return stopping || queued > 0; });
+            --idle;
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t threads = std::thread::hardware_concurrency()) {
+        threads = std::max<size_t>(1, threads);
+        for (size_t i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(&WorkStealingPool::work, this, i);
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Threads that run tasks, counting the one that waits
+    size_t size() const {
+        return queues.size();
+    }
+
+    // True when some thread has nothing to run and nothing is queued, so splitting off work would help
+    bool wants_work() const {
+        return idle > 0 && queued == 0;
+    }
+
+    void spawn(TaskGroup& group, std::function<void()> fn) {
+        ++group.pending;
+        push([&group, fn = std::move(fn)] {
+            try {
+                fn();
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(group.error_lock);
+                if (!group.error) group.error = std::current_exception();
+            }
+            --group.pending;
+        });
+    }
+
+    // Run tasks until every task of the group is done.
+    // While it finds nothing to run the waiting thread counts as idle, so running tasks split work off for it.
+    void wait(TaskGroup& group) {
+        bool waiting = false;
+        Task task;
+        while (group.pending > 0) {
+            if (take(task)) {
+                if (waiting) {
+                    --idle;
+                    waiting = false;
+                }
+                task();
+            } else {
+                if (!waiting) {
+                    ++idle;
+                    waiting = true;
+                }
+                std::this_thread::yield();
+            }
+        }
+        if (waiting) --idle;
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+};
+
+// Pool shared by the parallel traversals, with one thread per hardware thread
+inline WorkStealingPool& default_pool() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+#endif
@@ -0,0 +1,174 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef TRAVERSAL_BUFFER_HPP
+#define TRAVERSAL_BUFFER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Number of entries the iterators keep inline before their stack or queue goes to the heap
+constexpr size_t TRAVERSAL_INLINE_CAPACITY = 32;
+
+// Stack that keeps its first N entries inline and only spills the rest to a vector.
+// The spill vector can be a caller-owned scratch buffer, so repeated traversals reuse its capacity.
+// A copy always owns its spill storage.
+template<typename E, size_t N = TRAVERSAL_INLINE_CAPACITY>
+class SmallStack {
+private:
+    std::array<E, N> items;     // left uninitialized, only [0, count) is ever read
+    size_t count = 0;
+    std::vector<E> own_spill;
+    std::vector<E>* spill;
+
+public:
+    SmallStack() : spill(&own_spill) {}
+
+    explicit SmallStack(std::vector<E>& scratch) : spill(&scratch) {
+        scratch.clear();
+    }
+
+    SmallStack(const SmallStack& other) : count(other.count), own_spill(*other.spill), spill(&own_spill) {
+        std::copy(other.items.begin(), other.items.begin() + std::min(count, N), items.begin());
+    }
+
+    SmallStack& operator=(const SmallStack& other) {
+        if (this != &other) {
+            count = other.count;
+            own_spill = *other.spill;
+            spill = &own_spill;
+            std::copy(other.items.begin(), other.items.begin() + std::min(count, N), items.begin());
+        }
+        return *this;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    void push(const E& item) {
+        if (count < N) {
+            items[count] = item;
+        } else {
+            spill->push_back(item);
+        }
+        ++count;
+    }
+
+    void pop() {
+        if (count > N) {
+            spill->pop_back();
+        }
+        --count;
+    }
+
+    E& top() {
+        return (count > N) ? spill->back() : items[count - 1];
+    }
+
+    const E& top() const {
+        return (count > N) ? spill->back() : items[count - 1];
+    }
+};
+
+// FIFO ring buffer that starts in N inline slots and moves to a vector once it outgrows them.
+// The capacity stays a power of two so wrapping around is a mask.
+// Like SmallStack, the vector can be a caller-owned scratch buffer.
+template<typename E, size_t N = TRAVERSAL_INLINE_CAPACITY>
+class SmallQueue {
+private:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SmallQueue capacity must be a power of two");
+
+    std::array<E, N> items;     // left uninitialized, only live ring slots are ever read
+    std::vector<E> own_heap;
+    std::vector<E>* heap;
+    E* data;
+    size_t capacity = N;
+    size_t head = 0;
+    size_t count = 0;
+
+    void grow() {
+        if (data == items.data()) {
+            heap->assign(items.begin(), items.end());
+            std::rotate(heap->begin(), heap->begin() + head, heap->end());
+        } else {
+            std::rotate(heap->begin(), heap->begin() + head, heap->begin() + capacity);
+        }
+        capacity *= 2;
+        heap->resize(capacity);
+        data = heap->data();
+        head = 0;
+    }
+
+    void copy_from(const SmallQueue& other) {
+        capacity = std::max(N, other.capacity);
+        if (other.count <= N) {
+            data = items.data();
+            capacity = N;
+        } else {
+            own_heap.resize(capacity);
+            data = own_heap.data();
+        }
+        heap = &own_heap;
+        head = 0;
+        count = other.count;
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = other.data[(other.head + i) & (other.capacity - 1)];
+        }
+    }
+
+public:
+    SmallQueue() : heap(&own_heap) {
+        data = items.data();
+    }
+
+    explicit SmallQueue(std::vector<E>& scratch) : heap(&scratch) {
+        data = items.data();
+    }
+
+    SmallQueue(const SmallQueue& other) {
+        copy_from(other);
+    }
+
+    SmallQueue& operator=(const SmallQueue& other) {
+        if (this != &other) {
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    void push(const E& item) {
+        if (count == capacity) {
+            grow();
+        }
+        data[(head + count) & (capacity - 1)] = item;
+        ++count;
+    }
+
+    void pop() {
+        head = (head + 1) & (capacity - 1);
+        --count;
+    }
+
+    E& front() {
+        return data[head];
+    }
+
+    const E& front() const {
+        return data[head];
+    }
+};
+
+#endif
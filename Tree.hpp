@@ -2,29 +2,92 @@
 #ifndef TREE_HPP
 #define TREE_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <queue>
 #include <stack>
 #include <algorithm>
+#include <iterator>
+#include <ranges>
 #include <memory>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
 #include "Node.hpp"
+#include "NodeArena.hpp"
+#include "ValueIndex.hpp"
 #include "PreOrderIterator.hpp"
 #include "PostOrderIterator.hpp"
 #include "InOrderIterator.hpp"
 #include "BfsIterator.hpp"
 #include "DfsIterator.hpp"
 #include "HeapIterator.hpp"
+#include "LevelIterator.hpp"
+#include "StacklessIterators.hpp"
+#include "ParallelHeap.hpp"
+
+// Where the tree allocates its nodes from
+enum class NodeStorage {
+    Shared,     // one std::make_shared allocation per node
+    Arena       // nodes carved from contiguous slabs, freed in one shot by clear()
+};
+
+// What a for_each callback asks the traversal to do next
+enum class VisitResult {
+    Continue,       // go on as usual
+    SkipChildren,   // do not descend below this node
+    Stop            // end the traversal now
+};
+
+// Reusable buffers for traversals that outgrow the iterators' inline stacks and queues.
+// Passing the same scratch to repeated begin_* calls makes those traversals allocation-free.
+// One scratch must serve only one live iterator at a time.
+template<typename T, size_t K>
+struct TraversalScratch {
+    std::vector<Node<T,K>*> nodes;
+    std::vector<PostOrderFrame<T,K>> frames;
+};
+
+// A traversal as a C++20 range: a begin iterator that ends itself, e.g. for (auto& v : tree.pre_order())
+template<typename Iterator>
+using TraversalRange = std::ranges::subrange<Iterator, std::default_sentinel_t>;
 
 // Tree class with k-ary tree implementation
 template<typename T, size_t K>
 class Tree {
 private:
     std::shared_ptr<Node<T,K>> root;    
+    NodeStorage storage_mode;
+    std::unique_ptr<NodeArena, RetireArena> arena;     // created by the first arena allocation
+    ValueIndex<T, Node<T,K>*> index;
+    bool indexed = false;
 
 public:
+    // Marks the root in the parent array passed to build_from_parents
+    static constexpr size_t NO_PARENT = static_cast<size_t>(-1);
+
     // Constructor for the Tree class
-    explicit Tree() : root(nullptr) {}
+    explicit Tree(NodeStorage storage = NodeStorage::Shared) : root(nullptr), storage_mode(storage) {}
+
+    // A copy would share the nodes but not the index, so trees are move-only
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+
+    Tree(Tree&&) = default;
+
+    // The nodes this tree held are torn down iteratively first, as in clear()
+    Tree& operator=(Tree&& other) {
+        if (this != &other) {
+            clear();
+            root = std::move(other.root);
+            storage_mode = other.storage_mode;
+            arena = std::move(other.arena);
+            index = std::move(other.index);
+            indexed = other.indexed;
+        }
+        return *this;
+    }
 
     std::shared_ptr<Node<T,K>> getRoot() const {
         return root;
@@ -37,27 +100,230 @@ public:
 
     // Clear the tree
     void clear() {
-        // No need to delete node explicitly, shared_ptr will handle it
+        // Tear the nodes down iteratively so deep trees do not overflow the stack
+        release_nodes(std::move(root));
         root = nullptr;
+        index.clear();
+        // The arena frees its slabs at once when its last node is gone, which is now
+        // unless a caller still holds some of them; the next allocation starts a new one
+        arena.reset();
     }    
 
-    // Function to add the root node
-    void add_root(const Node<T,K>& node) {
-        root = std::make_shared<Node<T,K>>(node);
+    // Keep a hash index from value to node so value based inserts skip the full search.
+    // Duplicate values are first-wins: the node indexed first keeps the value.
+    void enable_index() {
+        static_assert(is_hashable<T>::value, "enable_index() requires a std::hash<T> specialization");
+        if (!indexed) {
+            indexed = true;
+            index_subtree(root.get());
+        }
+    }
+
+    void disable_index() {
+        indexed = false;
+        index.clear();
     }
 
-    // Function to add a child node to a given parent node
-    void add_sub_node(Node<T,K>& parent_node, const Node<T,K>& child_node) {    
-        auto tree_node = find_node(root, parent_node.get_value());            
-        if (tree_node) {
-            tree_node->add_child(std::make_shared<Node<T,K>>(child_node));
+    bool has_index() const {
+        return indexed;
+    }
+
+    // Find the node holding a value, through the index when enabled
+    NodeHandle<T,K> find(const T& value) {
+        if constexpr (is_hashable<T>::value) {
+            if (indexed) {
+                return NodeHandle<T,K>(index.find(value));
+            }
         }
+        return NodeHandle<T,K>(find_node(root, value).get());
+    }
+
+    NodeStorage storage() const {
+        return storage_mode;
+    }
+
+    // Allocate a detached node from this tree's storage, to be linked with Node::add_child
+    std::shared_ptr<Node<T,K>> create_node(const Node<T,K>& node) {
+        auto copy = allocate_node(node);
+        copy_children(copy.get());
+        return copy;
+    }
+
+    std::shared_ptr<Node<T,K>> create_node(Node<T,K>&& node) {
+        return allocate_node(std::move(node));
+    }
+
+    // Function to add the root node
+    NodeHandle<T,K> add_root(const Node<T,K>& node) {
+        return set_root(create_node(node));
+    }
+
+    NodeHandle<T,K> add_root(Node<T,K>&& node) {
+        return set_root(allocate_node(std::move(node)));
+    }
+
+    // Construct the root value in place from args, with no copy of T
+    template<typename... Args>
+    NodeHandle<T,K> emplace_root(Args&&... args) {
+        return set_root(allocate_node(std::in_place, std::forward<Args>(args)...));
+    }
+
+    // Function to add a child node to a given parent node.
+    // The parent is searched by value (see enable_index); prefer the handle overload when building large trees.
+    NodeHandle<T,K> add_sub_node(Node<T,K>& parent_node, const Node<T,K>& child_node) {    
+        return insert_child(find(parent_node.get_value()), child_node);
     }    
+
+    NodeHandle<T,K> add_sub_node(Node<T,K>& parent_node, Node<T,K>&& child_node) {
+        return insert_child(find(parent_node.get_value()), std::move(child_node));
+    }
+
+    // Function to add a child node under a handle returned by an earlier insert, in O(1).
+    // Returns an empty handle if the parent already has K children.
+    NodeHandle<T,K> add_sub_node(NodeHandle<T,K> parent, const Node<T,K>& child_node) {
+        return insert_child(parent, child_node);
+    }
+
+    NodeHandle<T,K> add_sub_node(NodeHandle<T,K> parent, Node<T,K>&& child_node) {
+        return insert_child(parent, std::move(child_node));
+    }
+
+    // Construct a child value in place from args under a handle, with no copy of T
+    template<typename... Args>
+    NodeHandle<T,K> emplace_child(NodeHandle<T,K> parent, Args&&... args) {
+        return insert_child(parent, std::in_place, std::forward<Args>(args)...);
+    }
+
+    // Replace the tree with values[i] as node i and parents[i] as its parent index
+    // (NO_PARENT for the single root), in one linear pass. Children keep their index order.
+    // Throws std::invalid_argument, leaving the tree unchanged, if the input is not a tree
+    // or a node gets more than K children.
+    void build_from_parents(const std::vector<T>& values, const std::vector<size_t>& parents) {
+        const size_t n = values.size();
+        if (parents.size() != n) {
+            throw std::invalid_argument("build_from_parents: values and parents differ in size");
+        }
+        if (n == 0) {
+            clear();
+            return;
+        }
+
+        // Count children per node and find the root; counts never exceed K, so a small K takes one byte per node
+        using ChildCount = std::conditional_t<(K < 256), uint8_t, size_t>;
+        size_t root_index = NO_PARENT;
+        bool parents_first = true;      // the root is node 0 and every parent comes before its children
+        std::vector<ChildCount> counts(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            parents_first = parents_first && (parents[i] == NO_PARENT ? i == 0 : parents[i] < i);
+            if (parents[i] == NO_PARENT) {
+                if (root_index != NO_PARENT) {
+                    throw std::invalid_argument("build_from_parents: more than one root");
+                }
+                root_index = i;
+            } else if (parents[i] >= n || parents[i] == i) {
+                throw std::invalid_argument("build_from_parents: invalid parent index");
+            } else if (counts[parents[i]]++ == K) {
+                throw std::invalid_argument("build_from_parents: node has more than K children");
+            }
+        }
+        if (root_index == NO_PARENT) {
+            throw std::invalid_argument("build_from_parents: no root");
+        }
+
+        // With parents first there can be no cycle, and linking in index order keeps children in index order
+        if (parents_first) {
+            clear();
+            std::vector<Node<T,K>*> nodes(n);
+            for (size_t i = 0; i < n; ++i) {
+                auto node = allocate_node(values[i]);
+                nodes[i] = node.get();
+                if constexpr (K > INLINE_CHILDREN_LIMIT) {
+                    node->get_children().reserve(counts[i]);
+                }
+                if (i == 0) {
+                    root = std::move(node);
+                } else {
+                    nodes[parents[i]]->add_child(std::move(node));
+                }
+            }
+            if (indexed) {
+                index.reserve(n);
+                index_subtree(root.get());
+            }
+            return;
+        }
+
+        // Group children by parent, in index order; children of node p end up in [offsets[p], offsets[p + 1])
+        std::vector<size_t> offsets(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            offsets[i + 1] = offsets[i] + counts[i];
+        }
+        std::vector<size_t> children(n - 1);
+        for (size_t i = n; i-- > 0;) {
+            if (parents[i] != NO_PARENT) {
+                children[offsets[parents[i]] + --counts[parents[i]]] = i;
+            }
+        }
+
+        // Every node must be reachable from the root, or parents contain a cycle
+        std::vector<size_t> pending{root_index};
+        size_t reached = 0;
+        while (!pending.empty()) {
+            size_t current = pending.back();
+            pending.pop_back();
+            ++reached;
+            pending.insert(pending.end(), children.begin() + offsets[current], children.begin() + offsets[current + 1]);
+        }
+        if (reached != n) {
+            throw std::invalid_argument("build_from_parents: parents contain a cycle");
+        }
+
+        // Walk down from the root again, allocating each node right before it is moved into its parent
+        clear();
+        root = allocate_node(values[root_index]);
+        std::vector<std::pair<Node<T,K>*, size_t>> building{{root.get(), root_index}};
+        while (!building.empty()) {
+            auto [node, current] = building.back();
+            building.pop_back();
+            if constexpr (K > INLINE_CHILDREN_LIMIT) {
+                node->get_children().reserve(offsets[current + 1] - offsets[current]);
+            }
+            for (size_t c = offsets[current]; c < offsets[current + 1]; ++c) {
+                auto child = allocate_node(values[children[c]]);
+                building.emplace_back(child.get(), children[c]);
+                node->add_child(std::move(child));
+            }
+        }
+        if (indexed) {
+            index.reserve(n);
+            index_subtree(root.get());
+        }
+    }
+
+    // Replace the tree with values[i] as node i and (parent, child) index pairs as its edges.
+    // Throws std::invalid_argument under the same rules as build_from_parents.
+    void build_from_edges(const std::vector<T>& values, const std::vector<std::pair<size_t,size_t>>& edges) {
+        std::vector<size_t> parents(values.size(), NO_PARENT);
+        for (const auto& edge : edges) {
+            if (edge.first >= values.size() || edge.second >= values.size()) {
+                throw std::invalid_argument("build_from_edges: invalid node index");
+            }
+            if (parents[edge.second] != NO_PARENT) {
+                throw std::invalid_argument("build_from_edges: node has more than one parent");
+            }
+            parents[edge.second] = edge.first;
+        }
+        build_from_parents(values, parents);
+    }
     
     PreOrderIterator<T,K> begin_pre_order() {
         return PreOrderIterator<T,K>(root);
     }
 
+    PreOrderIterator<T,K> begin_pre_order(TraversalScratch<T,K>& scratch) {
+        return PreOrderIterator<T,K>(root, scratch.nodes);
+    }
+
     PreOrderIterator<T,K> end_pre_order() {
         return PreOrderIterator<T,K>(nullptr);
     }    
@@ -66,6 +332,10 @@ public:
         return PostOrderIterator<T,K>(root);
     }
 
+    PostOrderIterator<T,K> begin_post_order(TraversalScratch<T,K>& scratch) {
+        return PostOrderIterator<T,K>(root, scratch.frames);
+    }
+
     PostOrderIterator<T,K> end_post_order() {
         return PostOrderIterator<T,K>(nullptr);
     }    
@@ -74,6 +344,10 @@ public:
         return InOrderIterator<T,K>(root);
     }
 
+    InOrderIterator<T,K> begin_in_order(TraversalScratch<T,K>& scratch) {
+        return InOrderIterator<T,K>(root, scratch.nodes);
+    }
+
     InOrderIterator<T,K> end_in_order() {
         return InOrderIterator<T,K>(nullptr);
     }
@@ -82,6 +356,10 @@ public:
         return BFSIterator<T,K>(root);
     }
 
+    BFSIterator<T,K> begin_bfs_scan(TraversalScratch<T,K>& scratch) {
+        return BFSIterator<T,K>(root, scratch.nodes);
+    }
+
     BFSIterator<T,K> end_bfs_scan() {
         return BFSIterator<T,K>(nullptr);
     }
@@ -90,11 +368,142 @@ public:
         return DFSIterator<T,K>(root);
     }
 
+    DFSIterator<T,K> begin_dfs_scan(TraversalScratch<T,K>& scratch) {
+        return DFSIterator<T,K>(root, scratch.nodes);
+    }
+
     DFSIterator<T,K> end_dfs_scan() {
         return DFSIterator<T,K>(nullptr);
     }
+
+    // Traversals in O(1) extra memory, walking the parent links instead of a stack
+    StacklessPreOrderIterator<T,K> begin_stackless_pre_order() {
+        return StacklessPreOrderIterator<T,K>(root.get());
+    }
+
+    StacklessPreOrderIterator<T,K> end_stackless_pre_order() {
+        return StacklessPreOrderIterator<T,K>(nullptr);
+    }
+
+    StacklessPostOrderIterator<T,K> begin_stackless_post_order() {
+        return StacklessPostOrderIterator<T,K>(root.get());
+    }
+
+    StacklessPostOrderIterator<T,K> end_stackless_post_order() {
+        return StacklessPostOrderIterator<T,K>(nullptr);
+    }
+
+    StacklessInOrderIterator<T,K> begin_stackless_in_order() {
+        return StacklessInOrderIterator<T,K>(root.get());
+    }
+
+    StacklessInOrderIterator<T,K> end_stackless_in_order() {
+        return StacklessInOrderIterator<T,K>(nullptr);
+    }
+
+    TraversalRange<PreOrderIterator<T,K>> pre_order() {
+        return {begin_pre_order(), std::default_sentinel};
+    }
+
+    TraversalRange<PostOrderIterator<T,K>> post_order() {
+        return {begin_post_order(), std::default_sentinel};
+    }
+
+    TraversalRange<InOrderIterator<T,K>> in_order() {
+        return {begin_in_order(), std::default_sentinel};
+    }
+
+    TraversalRange<BFSIterator<T,K>> bfs() {
+        return {begin_bfs_scan(), std::default_sentinel};
+    }
+
+    TraversalRange<DFSIterator<T,K>> dfs() {
+        return {begin_dfs_scan(), std::default_sentinel};
+    }
+
+    // Values in ascending order (see myHeap)
+    TraversalRange<HeapIterator<T,K>> heap() {
+        return {myHeap(), std::default_sentinel};
+    }
+
+    // Internal iteration: call f(value) on every node in pre-order.
+    // f may return void, bool where false stops the scan, or a VisitResult to also prune subtrees.
+    // Returns false if the scan was stopped.
+    template<typename F>
+    bool for_each_pre_order(F&& f) const {
+        SmallStack<Node<T,K>*> stack;
+        if (root) stack.push(root.get());
+        while (!stack.empty()) {
+            Node<T,K>* node = stack.top();
+            stack.pop();
+            VisitResult result = visit(f, node->get_value());
+            if (result == VisitResult::Stop) return false;
+            if (result == VisitResult::SkipChildren) continue;
+            const auto& children = node->get_children();
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                stack.push(it->get());
+            }
+        }
+        return true;
+    }
+
+    // Children are visited before their parent, so SkipChildren acts like Continue here
+    template<typename F>
+    bool for_each_post_order(F&& f) const {
+        SmallStack<PostOrderFrame<T,K>> stack;
+        Node<T,K>* next = root.get();
+        while (true) {
+            // Push the chain of first children, then visit upwards until a sibling is left
+            for (; next != nullptr; next = next->get_children().empty() ? nullptr : next->get_children().front().get()) {
+                stack.push({next, 1});
+            }
+            if (stack.empty()) return true;
+            Node<T,K>* node = stack.top().node;
+            stack.pop();
+            if (visit(f, node->get_value()) == VisitResult::Stop) return false;
+            if (!stack.empty()) {
+                PostOrderFrame<T,K>& parent = stack.top();
+                const auto& siblings = parent.node->get_children();
+                if (parent.next_child < siblings.size()) {
+                    next = siblings[parent.next_child++].get();
+                }
+            }
+        }
+    }
+
+    template<typename F>
+    bool for_each_bfs(F&& f) const {
+        SmallQueue<Node<T,K>*> queue;
+        if (root) queue.push(root.get());
+        while (!queue.empty()) {
+            Node<T,K>* node = queue.front();
+            queue.pop();
+            VisitResult result = visit(f, node->get_value());
+            if (result == VisitResult::Stop) return false;
+            if (result == VisitResult::SkipChildren) continue;
+            for (const auto& child : node->get_children()) {
+                queue.push(child.get());
+            }
+        }
+        return true;
+    }
+
+    // Level by level BFS, for per-level batch processing
+    LevelIterator<T,K> begin_levels() {
+        return LevelIterator<T,K>(root);
+    }
+
+    LevelIterator<T,K> end_levels() {
+        return LevelIterator<T,K>(nullptr);
+    }
     
+    // Values in ascending order. A heap-ordered tree is walked lazily through its frontier instead of
+    // copying and heapifying every value. The order is checked on every call, so changes made through
+    // Node::add_child are seen; on other trees the check stops at the first parent above a child.
     HeapIterator<T,K> myHeap() {
+        if (is_heap_ordered()) {
+            return HeapIterator<T,K>(root, frontier_scan);
+        }
         return HeapIterator<T,K>(root);
     }    
 
@@ -102,8 +511,146 @@ public:
         std::shared_ptr<Node<T,K>> empty;
         return HeapIterator<T,K>(empty);
     }
+
+    // True when no node is greater than any of its children (a min-heap), checked in O(n)
+    bool is_heap_ordered() const {
+        bool ordered = true;
+        SmallStack<const Node<T,K>*> pending;
+        if (root) pending.push(root.get());
+        while (ordered && !pending.empty()) {
+            const Node<T,K>* node = pending.top();
+            pending.pop();
+            for (const auto& child : node->get_children()) {
+                if (node->get_value() > child->get_value()) {
+                    ordered = false;
+                    break;
+                }
+                pending.push(child.get());
+            }
+        }
+        return ordered;
+    }
+
+    // Sorted scan built on several threads: each sorts a share of the subtrees, and the sorted runs
+    // are merged lazily as the iterator advances. threads = 0 uses every hardware thread.
+    template<typename Compare = std::greater<T>>
+    MergeHeapIterator<T,Compare> begin_parallel_heap(size_t threads = 0, Compare comp = Compare()) const {
+        if (threads == 0) {
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        return MergeHeapIterator<T,Compare>(sorted_runs(root.get(), threads, comp), comp);
+    }
+
+    template<typename Compare = std::greater<T>>
+    TraversalRange<MergeHeapIterator<T,Compare>> parallel_heap(size_t threads = 0, Compare comp = Compare()) const {
+        return {begin_parallel_heap(threads, comp), std::default_sentinel};
+    }
+
+    // The first k values of the sorted scan, in O(n log k) time and O(k) memory
+    template<typename Compare = std::greater<T>>
+    std::vector<T> top_k(size_t k, Compare comp = Compare()) const {
+        TopK<T,Compare> selection(k, comp);
+        for_each_pre_order([&](const T& value) { selection.push(value); });
+        return selection.take();
+    }
           
 private:
+    // Helper function to call a for_each callback and map its return value to a VisitResult
+    template<typename F>
+    static VisitResult visit(F& f, const T& value) {
+        using Result = decltype(f(value));
+        if constexpr (std::is_void_v<Result>) {
+            f(value);
+            return VisitResult::Continue;
+        } else if constexpr (std::is_same_v<Result, VisitResult>) {
+            return f(value);
+        } else {
+            return static_cast<bool>(f(value)) ? VisitResult::Continue : VisitResult::Stop;
+        }
+    }
+
+    // Helper function to allocate a node from the tree's storage, forwarding args to the Node constructor
+    template<typename... Args>
+    std::shared_ptr<Node<T,K>> allocate_node(Args&&... args) {
+        if (storage_mode == NodeStorage::Arena) {
+            if (!arena) arena.reset(new NodeArena());
+            return std::allocate_shared<Node<T,K>>(ArenaAllocator<Node<T,K>>(arena.get()), std::forward<Args>(args)...);
+        }
+        return std::make_shared<Node<T,K>>(std::forward<Args>(args)...);
+    }
+
+    // Helper function to replace the children a copied node shares with the original by copies.
+    // Below the root, shared children would keep their parent links to the original node, which
+    // the stackless iterators climb through. Works through a list so deep subtrees do not recurse.
+    void copy_children(Node<T,K>* node) {
+        std::vector<Node<T,K>*> pending{node};
+        while (!pending.empty()) {
+            Node<T,K>* current = pending.back();
+            pending.pop_back();
+            auto& children = current->get_children();
+            if (children.empty()) continue;
+            auto shared = std::move(children);
+            children.clear();
+            for (const auto& child : shared) {
+                auto copy = allocate_node(std::as_const(*child));
+                current->add_child(copy);
+                pending.push_back(copy.get());
+            }
+        }
+    }
+
+    // Helper function to replace the root; the old nodes are torn down iteratively, as in clear()
+    NodeHandle<T,K> set_root(std::shared_ptr<Node<T,K>> node) {
+        release_nodes(std::move(root));
+        root = std::move(node);
+        if (indexed) {
+            index.clear();
+            index_subtree(root.get());
+        }
+        return NodeHandle<T,K>(root.get());
+    }
+
+    // True when args copy an existing Node, whose children are then shared with it
+    template<typename... Args>
+    static constexpr bool copies_node = sizeof...(Args) == 1 && (std::is_lvalue_reference_v<Args> && ...)
+                                        && (std::is_same_v<std::decay_t<Args>, Node<T,K>> && ...);
+
+    // Helper function to build a child from args and link it under parent
+    template<typename... Args>
+    NodeHandle<T,K> insert_child(NodeHandle<T,K> parent, Args&&... args) {
+        if (!parent || parent->get_children().size() >= K) {
+            return NodeHandle<T,K>();
+        }
+        auto child = allocate_node(std::forward<Args>(args)...);
+        if constexpr (copies_node<Args...>) {
+            copy_children(child.get());
+        }
+        parent->add_child(child);
+        if (indexed) {
+            index_subtree(child.get());
+        }
+        return NodeHandle<T,K>(child.get());
+    }
+
+    // Helper function to destroy a subtree without recursing once per level.
+    // Children are detached only from nodes this tree owns exclusively; subtrees still
+    // shared with another tree or a caller are left intact.
+    static void release_nodes(std::shared_ptr<Node<T,K>> node) {
+        std::vector<std::shared_ptr<Node<T,K>>> pending;
+        pending.push_back(std::move(node));
+        while (!pending.empty()) {
+            std::shared_ptr<Node<T,K>> current = std::move(pending.back());
+            pending.pop_back();
+            if (current && current.use_count() == 1) {
+                auto& children = current->get_children();
+                for (auto& child : children) {
+                    pending.push_back(std::move(child));
+                }
+                children.clear();
+            }
+        }
+    }
+
     // Helper function to find a node by value
     std::shared_ptr<Node<T,K>> find_node(std::shared_ptr<Node<T,K>> node, const T& value) {
         if (!node) return nullptr;
@@ -114,6 +661,23 @@ private:
         }
         return nullptr;
     }    
+
+    // Helper function to add a node and its descendants to the value index
+    void index_subtree(Node<T,K>* node) {
+        if constexpr (is_hashable<T>::value) {
+            std::stack<Node<T,K>*> pending;
+            if (node) pending.push(node);
+            while (!pending.empty()) {
+                Node<T,K>* current = pending.top();
+                pending.pop();
+                index.insert(current->get_value(), current);
+                auto& children = current->get_children();
+                for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                    pending.push(it->get());
+                }
+            }
+        }
+    }
 };
 
 #endif
@@ -0,0 +1,54 @@
+// ariel.levovich@msmail.ariel.ac.il
+#ifndef VALUE_INDEX_HPP
+#define VALUE_INDEX_HPP
+
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+// True when std::hash<T> is usable, so trees of unhashable types still compile without an index
+template<typename T, typename = void>
+struct is_hashable : std::false_type {};
+
+template<typename T>
+struct is_hashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type {};
+
+// Hash map from a value to the node holding it.
+// Duplicate values follow a first-wins policy: the earliest indexed node keeps the key.
+template<typename T, typename NodePtr>
+class ValueIndex {
+private:
+    // Defers the use of std::hash<T> until a value is actually hashed
+    struct ValueHash {
+        size_t operator()(const T& value) const {
+            return std::hash<T>{}(value);
+        }
+    };
+
+    std::unordered_map<T, NodePtr, ValueHash> map;
+
+public:
+    void insert(const T& value, NodePtr node) {
+        map.emplace(value, node);
+    }
+
+    NodePtr find(const T& value) const {
+        auto it = map.find(value);
+        return (it == map.end()) ? NodePtr() : it->second;
+    }
+
+    void reserve(size_t n) {
+        map.reserve(n);
+    }
+
+    void clear() {
+        map.clear();
+    }
+
+    size_t size() const {
+        return map.size();
+    }
+};
+
+#endif
@@ -1,3 +1,4 @@
 QT += widgets
+CONFIG += c++2a thread
 SOURCES += Demo.cpp TreeWidget.cpp TreeWidgetDouble3.cpp TreeWidgetComplex2.cpp
-HEADERS += TreeWidget.hpp TreeWidgetDouble3.hpp TreeWidgetComplex2.hpp Tree.hpp Node.hpp Complex.hpp BfsIterator.hpp DfsIterator.hpp HeapIterator.hpp InOrderIterator.hpp PostOrderIterator.hpp PreOrderIterator.hpp
\ No newline at end of file
+HEADERS += TreeWidget.hpp TreeWidgetDouble3.hpp TreeWidgetComplex2.hpp Tree.hpp Node.hpp Complex.hpp BfsIterator.hpp DfsIterator.hpp HeapIterator.hpp InOrderIterator.hpp PostOrderIterator.hpp PreOrderIterator.hpp NodeArena.hpp ChildArray.hpp IndexIterators.hpp FlatTree.hpp ImplicitTree.hpp ValueIndex.hpp TraversalBuffer.hpp LevelIterator.hpp StacklessIterators.hpp ParallelHeap.hpp RadixSort.hpp ComplexArray.hpp ThreadPool.hpp ParallelTraversal.hpp
\ No newline at end of file